@@ -0,0 +1,57 @@
+#include "allocstats.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<long long> totalCount(0);
+static std::atomic<long long> totalBytes(0);
+
+static long long frameStartCount = 0, frameStartBytes = 0;
+static int historyCount[ALLOC_HISTORY];
+static long long historyBytes[ALLOC_HISTORY];
+static int historyHead = 0, historyFrames = 0;
+
+static void* CountedAlloc(size_t size) {
+    totalCount.fetch_add(1, std::memory_order_relaxed);
+    totalBytes.fetch_add((long long)size, std::memory_order_relaxed);
+    void* p = malloc(size > 0 ? size : 1);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+// The nothrow and array forms of the standard library forward to these
+void* operator new(size_t size) { return CountedAlloc(size); }
+void* operator new[](size_t size) { return CountedAlloc(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+int AllocEndFrame() {
+    long long count = totalCount.load(std::memory_order_relaxed);
+    long long bytes = totalBytes.load(std::memory_order_relaxed);
+    int frameCount = (int)(count - frameStartCount);
+    historyCount[historyHead] = frameCount;
+    historyBytes[historyHead] = bytes - frameStartBytes;
+    historyHead = (historyHead + 1) % ALLOC_HISTORY;
+    if (historyFrames < ALLOC_HISTORY) historyFrames++;
+    frameStartCount = count;
+    frameStartBytes = bytes;
+    return frameCount;
+}
+
+AllocFrameStats AllocGetStats() {
+    AllocFrameStats s = {};
+    s.frames = historyFrames;
+    if (historyFrames == 0) return s;
+
+    int last = (historyHead + ALLOC_HISTORY - 1) % ALLOC_HISTORY;
+    s.count = historyCount[last];
+    s.bytes = historyBytes[last];
+    for (int i = 0; i < historyFrames; i++) {
+        if (historyCount[i] > s.peakCount) s.peakCount = historyCount[i];
+        if (historyBytes[i] > s.peakBytes) s.peakBytes = historyBytes[i];
+        if (historyCount[i] > 0) s.framesWithAllocs++;
+    }
+    return s;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+// Counts heap allocations made through operator new on any thread (the sim
+// worker included), so the steady-state game loop can be held to zero. C
+// mallocs, raylib's own included, don't go through here. The counting is
+// two relaxed atomic adds per allocation and only lives in the game.
+struct AllocFrameStats {
+    int count;          // last frame
+    long long bytes;
+    int peakCount;      // over the last ALLOC_HISTORY frames
+    long long peakBytes;
+    int framesWithAllocs;
+    int frames;         // in the history so far
+};
+
+const int ALLOC_HISTORY = 240; // frames, 4 s at 60 fps
+
+// Once a frame, after EndDrawing. Returns what that frame allocated.
+int AllocEndFrame();
+AllocFrameStats AllocGetStats();
@@ -0,0 +1,49 @@
+#include "arena.h"
+#include "raylib.h"
+#include <cstdlib>
+
+FrameArena frameArena;
+
+// Heap fallbacks are chained through a header in front of the block
+struct OverflowBlock {
+    OverflowBlock* next;
+    std::max_align_t pad; // keeps the data after it aligned
+};
+
+void FrameArena::Init(size_t size) {
+    Shutdown();
+    base = static_cast<unsigned char*>(malloc(size));
+    capacity = base != nullptr ? size : 0;
+}
+
+void FrameArena::Shutdown() {
+    Reset();
+    free(base);
+    base = nullptr;
+    capacity = 0;
+}
+
+void* FrameArena::Alloc(size_t size, size_t align) {
+    size_t start = (used + align - 1) & ~(align - 1);
+    if (start + size <= capacity) {
+        used = start + size;
+        return base + start;
+    }
+
+    if (overflows++ == 0) TraceLog(LOG_WARNING, "Frame arena full (%d bytes), falling back to the heap", (int)capacity);
+    OverflowBlock* block = static_cast<OverflowBlock*>(malloc(sizeof(OverflowBlock) + size));
+    if (block == nullptr) return nullptr;
+    block->next = static_cast<OverflowBlock*>(overflowList);
+    overflowList = block;
+    return &block->pad;
+}
+
+void FrameArena::Reset() {
+    if (used > peak) peak = used;
+    used = 0;
+    while (overflowList != nullptr) {
+        OverflowBlock* block = static_cast<OverflowBlock*>(overflowList);
+        overflowList = block->next;
+        free(block);
+    }
+}
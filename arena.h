@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+
+// Linear allocator for data that only lives until the end of the frame:
+// Alloc bumps a pointer and Reset() after EndDrawing drops everything at
+// once. The buffer is allocated once at startup. A frame that needs more
+// than that gets the extra from the heap (counted in `overflows`, freed at
+// the next reset), so nothing breaks, but FRAME_ARENA_SIZE should go up.
+// Main thread only.
+const size_t FRAME_ARENA_SIZE = 64 * 1024;
+
+struct FrameArena {
+    unsigned char* base = nullptr;
+    size_t capacity = 0;
+    size_t used = 0;
+    size_t peak = 0;     // most used in any frame
+    int overflows = 0;   // heap fallbacks since startup
+    void* overflowList = nullptr;
+
+    void Init(size_t size);
+    void Shutdown();
+
+    void* Alloc(size_t size, size_t align = alignof(std::max_align_t));
+    void Reset();
+
+    // Uninitialized, for plain data
+    template <typename T>
+    T* AllocArray(size_t count) {
+        return static_cast<T*>(Alloc(sizeof(T) * count, alignof(T)));
+    }
+};
+
+extern FrameArena frameArena;
@@ -0,0 +1,195 @@
+#include "atlas.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+const char* const SPRITE_NAMES[SPRITE_COUNT] = { "floor", "player", "box", "spike", "particle", "white" };
+
+// Sprites before this one are PNGs in assets/, the rest get generated
+const int SPRITE_FIRST_GENERATED = SPRITE_PARTICLE;
+
+Atlas atlas;
+
+static std::string AssetPath(const char* dir, const char* file) {
+    return std::string(dir) + "/" + file;
+}
+
+bool LoadSpriteImages(const char* assetDir, Image images[SPRITE_COUNT]) {
+    for (int i = 0; i < SPRITE_FIRST_GENERATED; i++) {
+        std::string path = AssetPath(assetDir, (std::string(SPRITE_NAMES[i]) + ".png").c_str());
+        images[i] = LoadImage(path.c_str());
+        if (images[i].data == NULL) {
+            TraceLog(LOG_WARNING, "Missing sprite %s", path.c_str());
+            for (int j = 0; j < i; j++) UnloadImage(images[j]);
+            return false;
+        }
+        ImageFormat(&images[i], PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    }
+
+    images[SPRITE_PARTICLE] = GenImageColor(32, 32, BLANK);
+    ImageDrawCircle(&images[SPRITE_PARTICLE], 16, 16, 15, WHITE);
+    images[SPRITE_WHITE] = GenImageColor(4, 4, WHITE);
+    return true;
+}
+
+static int NextPow2(int v) {
+    int p = 1;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+// Rows ("shelves") of images sorted tallest first, `width` wide. Returns
+// the height used.
+static int ShelfPack(const Image images[SPRITE_COUNT], const int order[SPRITE_COUNT], int width, Rectangle rects[SPRITE_COUNT]) {
+    int x = 0, y = 0, shelfHeight = 0;
+    for (int k = 0; k < SPRITE_COUNT; k++) {
+        int i = order[k];
+        int w = images[i].width + 2 * ATLAS_PADDING;
+        int h = images[i].height + 2 * ATLAS_PADDING;
+        if (x + w > width) {
+            x = 0;
+            y += shelfHeight;
+            shelfHeight = 0;
+        }
+        rects[i] = { (float)(x + ATLAS_PADDING), (float)(y + ATLAS_PADDING), (float)images[i].width, (float)images[i].height };
+        x += w;
+        shelfHeight = std::max(shelfHeight, h);
+    }
+    return y + shelfHeight;
+}
+
+Image PackAtlasImage(const Image images[SPRITE_COUNT], Rectangle rects[SPRITE_COUNT]) {
+    int order[SPRITE_COUNT];
+    int widest = 0;
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        order[i] = i;
+        widest = std::max(widest, images[i].width + 2 * ATLAS_PADDING);
+    }
+    std::sort(order, order + SPRITE_COUNT, [&](int a, int b) { return images[a].height > images[b].height; });
+
+    // Smallest power of two square-ish size it fits in, POT keeps WebGL 1 happy
+    int width = NextPow2(widest);
+    int height = ShelfPack(images, order, width, rects);
+    while (NextPow2(height) > width) {
+        width *= 2;
+        height = ShelfPack(images, order, width, rects);
+    }
+
+    Image out = GenImageColor(width, NextPow2(height), BLANK);
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        const Image& img = images[i];
+        Rectangle r = rects[i];
+        float w = (float)img.width, h = (float)img.height, p = (float)ATLAS_PADDING;
+
+        // Edge rows/columns stretched into the padding, then the sprite itself
+        ImageDraw(&out, img, { 0, 0, w, 1 }, { r.x, r.y - p, w, p }, WHITE);
+        ImageDraw(&out, img, { 0, h - 1, w, 1 }, { r.x, r.y + h, w, p }, WHITE);
+        ImageDraw(&out, img, { 0, 0, 1, h }, { r.x - p, r.y, p, h }, WHITE);
+        ImageDraw(&out, img, { w - 1, 0, 1, h }, { r.x + w, r.y, p, h }, WHITE);
+        ImageDraw(&out, img, { 0, 0, w, h }, r, WHITE);
+    }
+    return out;
+}
+
+bool SaveAtlasTable(const char* path, const Rectangle rects[SPRITE_COUNT], int width, int height) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) return false;
+    fprintf(file, "calculusdash-atlas 1 %d %d\n", width, height);
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        fprintf(file, "%s %d %d %d %d\n", SPRITE_NAMES[i], (int)rects[i].x, (int)rects[i].y, (int)rects[i].width, (int)rects[i].height);
+    }
+    fclose(file);
+    return true;
+}
+
+bool LoadAtlasTable(const char* path, Rectangle rects[SPRITE_COUNT], int& width, int& height) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) return false;
+
+    char line[256];
+    int version = 0;
+    if (!fgets(line, sizeof(line), file) || sscanf(line, "calculusdash-atlas %d %d %d", &version, &width, &height) != 3 || version != 1) {
+        fclose(file);
+        return false;
+    }
+
+    bool found[SPRITE_COUNT] = {};
+    char name[64];
+    int x, y, w, h;
+    while (fgets(line, sizeof(line), file)) {
+        if (sscanf(line, "%63s %d %d %d %d", name, &x, &y, &w, &h) != 5) continue;
+        for (int i = 0; i < SPRITE_COUNT; i++) {
+            if (strcmp(name, SPRITE_NAMES[i]) != 0) continue;
+            rects[i] = { (float)x, (float)y, (float)w, (float)h };
+            found[i] = true;
+        }
+    }
+    fclose(file);
+
+    for (bool f : found) {
+        if (!f) return false; // table from before a sprite was added
+    }
+    return true;
+}
+
+// The packed atlas is stale if any loose sprite was edited after it
+static bool AtlasUpToDate(const char* assetDir, const std::string& png, const std::string& table) {
+    if (!FileExists(png.c_str()) || !FileExists(table.c_str())) return false;
+    long packed = std::min(GetFileModTime(png.c_str()), GetFileModTime(table.c_str()));
+    for (int i = 0; i < SPRITE_FIRST_GENERATED; i++) {
+        std::string src = AssetPath(assetDir, (std::string(SPRITE_NAMES[i]) + ".png").c_str());
+        if (FileExists(src.c_str()) && GetFileModTime(src.c_str()) > packed) return false;
+    }
+    return true;
+}
+
+bool LoadAtlasImage(const char* assetDir, Image& image) {
+    std::string png = AssetPath(assetDir, "atlas.png");
+    std::string table = AssetPath(assetDir, "atlas.txt");
+
+    image = Image{ 0 };
+    if (AtlasUpToDate(assetDir, png, table) && LoadAtlasTable(table.c_str(), atlas.rects, atlas.width, atlas.height)) {
+        image = LoadImage(png.c_str());
+    }
+
+    if (image.data == NULL) {
+        TraceLog(LOG_INFO, "No up to date %s, packing sprites at startup (run tools/atlaspack)", png.c_str());
+        Image images[SPRITE_COUNT];
+        if (!LoadSpriteImages(assetDir, images)) return false;
+        image = PackAtlasImage(images, atlas.rects);
+        for (Image& img : images) UnloadImage(img);
+    }
+
+    atlas.width = image.width;
+    atlas.height = image.height;
+    return true;
+}
+
+void UploadAtlas(Image& image) {
+    if (image.data == NULL) return;
+    if (atlas.texture.id != 0) UnloadTexture(atlas.texture);
+    atlas.texture = LoadTextureFromImage(image);
+    UnloadImage(image);
+    image = Image{ 0 };
+    SetTextureWrap(atlas.texture, TEXTURE_WRAP_CLAMP);
+}
+
+bool LoadAtlas(const char* assetDir) {
+    UnloadAtlas();
+    Image image;
+    if (!LoadAtlasImage(assetDir, image)) return false;
+    UploadAtlas(image);
+    return atlas.texture.id != 0;
+}
+
+void UnloadAtlas() {
+    if (atlas.texture.id != 0) UnloadTexture(atlas.texture);
+    atlas = Atlas();
+}
+
+void DrawSprite(SpriteId id, Rectangle dst, Vector2 origin, float rotation, Color tint, bool flipY) {
+    Rectangle src = atlas.rects[id];
+    if (flipY) src.height = -src.height;
+    DrawTexturePro(atlas.texture, src, dst, origin, rotation, tint);
+}
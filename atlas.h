@@ -0,0 +1,58 @@
+#pragma once
+
+#include "raylib.h"
+
+// Every world sprite lives in one texture so tiles, player, particles and
+// the trail can share a batch instead of flushing on each texture switch.
+// tools/atlaspack packs assets/ into assets/atlas.png plus a rect table
+// (assets/atlas.txt, one "name x y w h" per line). When those are missing or
+// older than the loose PNGs the game packs the same thing at startup.
+// The background is a full screen tiled texture and stays on its own.
+enum SpriteId {
+    SPRITE_FLOOR,
+    SPRITE_PLAYER,
+    SPRITE_BOX,
+    SPRITE_SPIKE,
+    SPRITE_PARTICLE, // generated: white disc
+    SPRITE_WHITE,    // generated: solid white, for shapes and the trail
+    SPRITE_COUNT
+};
+
+// Name in atlas.txt, also the PNG in assets/ for the loaded ones
+extern const char* const SPRITE_NAMES[SPRITE_COUNT];
+
+const int ATLAS_PADDING = 2; // edge pixels get repeated into it, no bleeding when scaled
+
+struct Atlas {
+    Texture2D texture = { 0 };
+    Rectangle rects[SPRITE_COUNT] = {};
+    int width = 0, height = 0;
+};
+
+extern Atlas atlas;
+
+// Source images, in SpriteId order. Loaded ones come from `assetDir`,
+// unloaded with UnloadImage. Returns false if one is missing.
+bool LoadSpriteImages(const char* assetDir, Image images[SPRITE_COUNT]);
+
+// Shelf-packs the images into one RGBA image, rects filled in SpriteId order
+Image PackAtlasImage(const Image images[SPRITE_COUNT], Rectangle rects[SPRITE_COUNT]);
+
+bool SaveAtlasTable(const char* path, const Rectangle rects[SPRITE_COUNT], int width, int height);
+bool LoadAtlasTable(const char* path, Rectangle rects[SPRITE_COUNT], int& width, int& height);
+
+// Uses assets/atlas.png + atlas.txt when they're up to date, otherwise
+// packs from the loose sprites. Fills in atlas.rects, no GL, so it can run
+// on the loader thread. UploadAtlas() (needs the window) makes the texture
+// and unloads the image.
+bool LoadAtlasImage(const char* assetDir, Image& image);
+void UploadAtlas(Image& image);
+
+// Both of the above
+bool LoadAtlas(const char* assetDir);
+void UnloadAtlas();
+
+inline Rectangle SpriteRect(SpriteId id) { return atlas.rects[id]; }
+
+// DrawTexturePro with a sprite as the source. flipY mirrors it vertically.
+void DrawSprite(SpriteId id, Rectangle dst, Vector2 origin, float rotation, Color tint, bool flipY = false);
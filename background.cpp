@@ -0,0 +1,140 @@
+#include "background.h"
+#include "shaders.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+Background background;
+
+// Back to front. speed is how far a layer moves per pixel the player does,
+// scale how much the texture is blown up and opacity how much of the layer
+// shows over the ones behind. The first one is the old tiled background.
+struct BackgroundLayer {
+    float speed, scale, opacity;
+};
+
+const int BACKGROUND_LAYERS = 2;
+const BackgroundLayer backgroundLayers[BACKGROUND_LAYERS] = {
+    { 0.8f, 1.0f, 1.0f },
+    { 1.2f, 2.0f, 0.15f }, // big blurry copy drifting past in front
+};
+
+// The old fallback gradient went on at 30% over the texture
+const float BACKGROUND_TINT_ALPHA = 0.3f;
+
+// fract() instead of REPEAT wrapping: the texture isn't a power of two and
+// WebGL 1 only repeats those
+static const char* BACKGROUND_FS_BODY =
+    "IN vec2 fragTexCoord;\n"
+    "uniform sampler2D texture0;\n"
+    "uniform vec2 screenSize;\n"
+    "uniform vec2 textureSize;\n"
+    "uniform vec3 layers[LAYERS];\n" // scroll in pixels, scale, opacity
+    "uniform int layerCount;\n"
+    "uniform vec4 tintTop;\n"
+    "uniform vec4 tintBottom;\n"
+    "void main() {\n"
+    "    vec2 pixel = fragTexCoord * screenSize;\n"
+    "    vec3 color = vec3(0.0);\n"
+    "    for (int i = 0; i < LAYERS; i++) {\n"
+    "        if (i >= layerCount) break;\n"
+    "        vec2 size = textureSize * layers[i].y;\n"
+    "        vec2 uv = fract(vec2(pixel.x + layers[i].x, pixel.y) / size);\n"
+    "        color = mix(color, TEXTURE(texture0, uv).rgb, layers[i].z);\n"
+    "    }\n"
+    "    vec4 tint = mix(tintTop, tintBottom, fragTexCoord.y);\n"
+    "    FINAL_COLOR = vec4(mix(color, tint.rgb, tint.a), 1.0);\n"
+    "}\n";
+
+static void SetColorUniform(int loc, Color c, float alpha) {
+    float v[4] = { c.r / 255.0f, c.g / 255.0f, c.b / 255.0f, alpha };
+    SetShaderValue(background.shader, loc, v, SHADER_UNIFORM_VEC4);
+}
+
+void InitBackground(Texture2D texture, Color tintTop, Color tintBottom) {
+    background.texture = texture;
+    background.tintTop = tintTop;
+    background.tintBottom = tintBottom;
+    background.useShader = false;
+    if (texture.id == 0) return;
+
+    std::string defines = "#define LAYERS " + std::to_string(BACKGROUND_LAYERS) + "\n";
+    background.shader = LoadFragmentShader("background", BACKGROUND_FS_BODY, defines.c_str());
+    if (background.shader.id == 0) {
+        TraceLog(LOG_WARNING, "Tiling the background texture instead");
+        return;
+    }
+    background.useShader = true;
+    SetTextureWrap(texture, TEXTURE_WRAP_CLAMP);
+
+    Shader& s = background.shader;
+    background.layersLoc = GetShaderLocation(s, "layers");
+    background.layerCountLoc = GetShaderLocation(s, "layerCount");
+    SetBackgroundLayers(background.layerCount > 0 ? background.layerCount : BACKGROUND_LAYERS);
+
+    // Everything but the layers' scroll is fixed, set it once
+    float screenSize[2] = { (float)GetScreenWidth(), (float)GetScreenHeight() };
+    float textureSize[2] = { (float)texture.width, (float)texture.height };
+    SetShaderValue(s, GetShaderLocation(s, "screenSize"), screenSize, SHADER_UNIFORM_VEC2);
+    SetShaderValue(s, GetShaderLocation(s, "textureSize"), textureSize, SHADER_UNIFORM_VEC2);
+
+    SetColorUniform(GetShaderLocation(s, "tintTop"), tintTop, BACKGROUND_TINT_ALPHA);
+    SetColorUniform(GetShaderLocation(s, "tintBottom"), tintBottom, BACKGROUND_TINT_ALPHA);
+}
+
+void UnloadBackground() {
+    UnloadFragmentShader(background.shader);
+    if (background.texture.id != 0) UnloadTexture(background.texture);
+    background = Background();
+}
+
+void SetBackgroundLayers(int count) {
+    background.layerCount = std::max(1, std::min(count, BACKGROUND_LAYERS));
+    if (background.useShader) SetShaderValue(background.shader, background.layerCountLoc, &background.layerCount, SHADER_UNIFORM_INT);
+}
+
+// The old way: tile the base layer by hand, then the tint on top
+static void DrawBackgroundTiled(float playerX) {
+    const Texture2D& tex = background.texture;
+    int screenWidth = GetScreenWidth(), screenHeight = GetScreenHeight();
+    // (skipped if it didn't load, a 0x0 texture would tile forever)
+    if (tex.id != 0) {
+        float scrollX = fmodf(playerX * backgroundLayers[0].speed, tex.width);
+        if (scrollX < 0) scrollX += tex.width;
+
+        for (int x = -scrollX; x < screenWidth; x += tex.width) {
+            for (int y = 0; y < screenHeight; y += tex.height) {
+                DrawTexture(tex, x, y, WHITE);
+            }
+        }
+    }
+
+    DrawRectangleGradientV(0, 0, screenWidth, screenHeight,
+                           Fade(background.tintTop, BACKGROUND_TINT_ALPHA),
+                           Fade(background.tintBottom, BACKGROUND_TINT_ALPHA));
+}
+
+void DrawBackground(float playerX) {
+    if (!background.useShader) {
+        DrawBackgroundTiled(playerX);
+        return;
+    }
+
+    const Texture2D& tex = background.texture;
+
+    // Scroll wrapped here rather than in the shader, so far into the level
+    // it doesn't eat the float precision
+    float layers[BACKGROUND_LAYERS * 3];
+    for (int i = 0; i < BACKGROUND_LAYERS; i++) {
+        const BackgroundLayer& l = backgroundLayers[i];
+        layers[i * 3 + 0] = fmodf(playerX * l.speed, tex.width * l.scale);
+        layers[i * 3 + 1] = l.scale;
+        layers[i * 3 + 2] = l.opacity;
+    }
+    SetShaderValueV(background.shader, background.layersLoc, layers, SHADER_UNIFORM_VEC3, BACKGROUND_LAYERS);
+
+    BeginShaderMode(background.shader);
+    DrawTexturePro(tex, { 0, 0, (float)tex.width, (float)tex.height },
+                   { 0, 0, (float)GetScreenWidth(), (float)GetScreenHeight() }, { 0, 0 }, 0.0f, WHITE);
+    EndShaderMode();
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "raylib.h"
+
+// The scrolling backdrop behind the level: one full screen quad and a
+// fragment shader that wraps the background texture, stacks the parallax
+// layers and puts the gradient tint on top, all in a single pass. If the
+// shader doesn't compile it falls back to tiling the texture with
+// DrawTexture plus a gradient rectangle, like it used to.
+struct Background {
+    Texture2D texture = { 0 };
+    Shader shader = { 0 };
+    bool useShader = false;
+    int layersLoc = -1;
+    int layerCountLoc = -1;
+    int layerCount = 0; // drawn, back to front (quality governor drops the front ones)
+    Color tintTop = BLANK, tintBottom = BLANK;
+};
+
+extern Background background;
+
+// Takes over `texture` (unloaded by UnloadBackground). Needs the window.
+void InitBackground(Texture2D texture, Color tintTop, Color tintBottom);
+void UnloadBackground();
+
+void SetBackgroundLayers(int count);
+
+// Full screen, scrolled for the player being at `playerX`
+void DrawBackground(float playerX);
@@ -0,0 +1,160 @@
+#include "bloom.h"
+#include "profiler.h"
+#include "shaders.h"
+#include "rlgl.h"
+
+Bloom bloom;
+
+// Soft threshold on the brightest channel, so the neon tints glow whatever
+// their hue
+static const char* EXTRACT_FS =
+    "IN vec2 fragTexCoord;\n"
+    "uniform sampler2D texture0;\n"
+    "uniform float threshold;\n"
+    "void main() {\n"
+    "    vec3 c = TEXTURE(texture0, fragTexCoord).rgb;\n"
+    "    float peak = max(c.r, max(c.g, c.b));\n"
+    "    FINAL_COLOR = vec4(c * smoothstep(threshold, threshold + 0.25, peak), 1.0);\n"
+    "}\n";
+
+// 9-tap gaussian in 5 fetches, the in-between taps come from bilinear
+// filtering. texel is one pixel along the blur direction.
+static const char* GAUSSIAN_FS =
+    "IN vec2 fragTexCoord;\n"
+    "uniform sampler2D texture0;\n"
+    "uniform vec2 texel;\n"
+    "void main() {\n"
+    "    vec3 c = TEXTURE(texture0, fragTexCoord).rgb * 0.2270270;\n"
+    "    c += TEXTURE(texture0, fragTexCoord + texel * 1.3846154).rgb * 0.3162162;\n"
+    "    c += TEXTURE(texture0, fragTexCoord - texel * 1.3846154).rgb * 0.3162162;\n"
+    "    c += TEXTURE(texture0, fragTexCoord + texel * 3.2307692).rgb * 0.0702703;\n"
+    "    c += TEXTURE(texture0, fragTexCoord - texel * 3.2307692).rgb * 0.0702703;\n"
+    "    FINAL_COLOR = vec4(c, 1.0);\n"
+    "}\n";
+
+static RenderTexture2D LoadFilteredTarget(int w, int h) {
+    RenderTexture2D target = LoadRenderTexture(w, h);
+    SetTextureFilter(target.texture, TEXTURE_FILTER_BILINEAR);
+    SetTextureWrap(target.texture, TEXTURE_WRAP_CLAMP);
+    return target;
+}
+
+static void UnloadTarget(RenderTexture2D& target) {
+    if (target.id != 0) UnloadRenderTexture(target);
+    target = { 0 };
+}
+
+void InitBloom() {
+    UnloadBloom();
+    bloom.extract = LoadFragmentShader("bloom extract", EXTRACT_FS);
+    bloom.gaussian = LoadFragmentShader("bloom blur", GAUSSIAN_FS);
+    bloom.shadersReady = bloom.extract.id != 0 && bloom.gaussian.id != 0;
+    if (!bloom.shadersReady) {
+        TraceLog(LOG_WARNING, "Bloom disabled");
+    } else {
+        SetShaderValue(bloom.extract, GetShaderLocation(bloom.extract, "threshold"), &bloom.threshold, SHADER_UNIFORM_FLOAT);
+        bloom.texelLoc = GetShaderLocation(bloom.gaussian, "texel");
+    }
+    SetBloomQuality(bloom.downscale, bloom.renderScale);
+}
+
+void UnloadBloom() {
+    UnloadFragmentShader(bloom.extract);
+    UnloadFragmentShader(bloom.gaussian);
+    UnloadTarget(bloom.scene);
+    for (RenderTexture2D& t : bloom.blur) UnloadTarget(t);
+    bloom.shadersReady = false;
+}
+
+void SetBloomQuality(int downscale, float renderScale) {
+    bloom.downscale = downscale;
+    bloom.renderScale = renderScale;
+
+    // Everything stays allocated while it's switched off with F5, so
+    // toggling doesn't hitch
+    int w = GetScreenWidth(), h = GetScreenHeight();
+    int sceneW = (int)(w * renderScale), sceneH = (int)(h * renderScale);
+    if (bloom.scene.texture.width != sceneW || bloom.scene.texture.height != sceneH) {
+        UnloadTarget(bloom.scene);
+        bloom.scene = LoadFilteredTarget(sceneW, sceneH);
+    }
+
+    int blurW = downscale > 0 ? w / downscale : 0, blurH = downscale > 0 ? h / downscale : 0;
+    for (RenderTexture2D& t : bloom.blur) {
+        if (t.texture.width == blurW && t.texture.height == blurH) continue;
+        UnloadTarget(t);
+        if (blurW > 0 && bloom.shadersReady) t = LoadFilteredTarget(blurW, blurH);
+    }
+}
+
+void SetBloom(bool enabled) {
+    bloom.enabled = enabled;
+}
+
+bool BloomActive() {
+    return bloom.enabled && bloom.shadersReady && bloom.downscale > 0 && bloom.blur[1].id != 0;
+}
+
+bool SceneTargetActive() {
+    return bloom.scene.id != 0 && (BloomActive() || bloom.renderScale < 1.0f);
+}
+
+void BeginBloomScene() {
+    if (!SceneTargetActive()) return;
+    BeginTextureMode(bloom.scene);
+    ClearBackground(BLACK);
+    // Keep drawing in screen coordinates whatever size the target is.
+    // BeginMode2D only touches the modelview, so this sticks.
+    rlMatrixMode(RL_PROJECTION);
+    rlLoadIdentity();
+    rlOrtho(0, GetScreenWidth(), GetScreenHeight(), 0, 0.0f, 1.0f);
+    rlMatrixMode(RL_MODELVIEW);
+}
+
+// Draws `from` over all of `to` through `shader`. Render textures come out
+// upside down, the negative source height flips them back on every pass.
+static void Blit(const RenderTexture2D& from, const RenderTexture2D& to, Shader shader) {
+    Rectangle src = { 0, 0, (float)from.texture.width, -(float)from.texture.height };
+    Rectangle dst = { 0, 0, (float)to.texture.width, (float)to.texture.height };
+    BeginTextureMode(to);
+    BeginShaderMode(shader);
+    DrawTexturePro(from.texture, src, dst, { 0, 0 }, 0.0f, WHITE);
+    EndShaderMode();
+    EndTextureMode();
+}
+
+static void BlurPass(const RenderTexture2D& from, const RenderTexture2D& to, float dx, float dy) {
+    float texel[2] = { dx / from.texture.width, dy / from.texture.height };
+    SetShaderValue(bloom.gaussian, bloom.texelLoc, texel, SHADER_UNIFORM_VEC2);
+    Blit(from, to, bloom.gaussian);
+}
+
+void EndBloomScene() {
+    if (!SceneTargetActive()) return;
+    EndTextureMode();
+    PROFILE_SCOPE("Bloom");
+
+    bool glow = BloomActive();
+    if (glow) {
+        // Brights at low res (bilinear filtering averages the skipped pixels)
+        Blit(bloom.scene, bloom.blur[0], bloom.extract);
+        BlurPass(bloom.blur[0], bloom.blur[1], 1.0f, 0.0f);
+        BlurPass(bloom.blur[1], bloom.blur[0], 0.0f, 1.0f);
+    }
+
+    // Scene as is, then the glow added on top. The scene's alpha got
+    // blended down under translucent sprites, but its colors are already
+    // final (drawn over black), so it goes on premultiplied.
+    Rectangle screen = { 0, 0, (float)GetScreenWidth(), (float)GetScreenHeight() };
+    const Texture2D& scene = bloom.scene.texture;
+    BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+    DrawTexturePro(scene, { 0, 0, (float)scene.width, -(float)scene.height }, screen, { 0, 0 }, 0.0f, WHITE);
+    EndBlendMode();
+    if (!glow) return;
+
+    const Texture2D& glowTex = bloom.blur[0].texture;
+    unsigned char a = (unsigned char)(bloom.intensity * 255.0f);
+    BeginBlendMode(BLEND_ADDITIVE);
+    DrawTexturePro(glowTex, { 0, 0, (float)glowTex.width, -(float)glowTex.height }, screen, { 0, 0 }, 0.0f, { 255, 255, 255, a });
+    EndBlendMode();
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "raylib.h"
+
+// Post-process glow. The world gets drawn into `scene` instead of the
+// screen; bright parts are picked out into a texture at 1/downscale of the
+// screen, blurred there with a separable gaussian (one horizontal and one
+// vertical pass, ping-ponging between two targets) and added back over the
+// scene. The cost is a few full screen quads at low resolution, the same
+// whatever is on screen.
+//
+// The same scene target lets the world render below screen resolution
+// (renderScale < 1) and get scaled up, with or without the glow.
+//
+// Toggle with SetBloom (F5 in game, --no-bloom at startup). With the glow
+// off (or the shaders not compiling) and full res, Begin/EndBloomScene do
+// nothing and the world goes straight to the screen as before.
+struct Bloom {
+    bool enabled = true;      // user toggle
+    int downscale = 2;        // glow resolution: 2 half, 4 quarter, 0 none (quality)
+    float renderScale = 1.0f; // scene resolution (quality)
+    bool shadersReady = false;
+    RenderTexture2D scene = { 0 };
+    RenderTexture2D blur[2] = {};
+    Shader extract = { 0 };
+    Shader gaussian = { 0 };
+    int texelLoc = -1;
+    float threshold = 0.6f; // brightest channel where glow starts
+    float intensity = 0.9f;
+};
+
+extern Bloom bloom;
+
+// Needs the window
+void InitBloom();
+void UnloadBloom();
+
+void SetBloom(bool enabled);
+// (Re)makes the targets if the sizes changed. Outside BeginDrawing.
+void SetBloomQuality(int downscale, float renderScale);
+
+bool BloomActive();       // glow gets drawn
+bool SceneTargetActive(); // world goes through the scene target at all
+
+// Around the world drawing, outside any other texture mode (chunk and text
+// baking have to happen before BeginBloomScene)
+void BeginBloomScene();
+void EndBloomScene();
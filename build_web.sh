@@ -0,0 +1,73 @@
+#!/bin/sh
+# ===============================
+# Web Build Script for GeomDash
+# ===============================
+#
+#   ./build_web.sh [--simd] [--out dir]
+#
+# Needs emsdk activated (em++ on the PATH, or EMSDK pointing at it) and
+# raylib built for the web: RAYLIB_SRC is its src/ folder (headers),
+# RAYLIB_WEB_LIB the folder with the web libraylib.a. The tools run on the
+# host and get built with CMake against the desktop raylib.
+#
+# --simd builds with -msimd128, the particle update then uses the WASM SIMD
+# kernel. Every browser from 2021 on runs it, older ones won't load it at all.
+set -e
+
+RAYLIB_SRC=${RAYLIB_SRC:-../raylib/src}
+RAYLIB_WEB_LIB=${RAYLIB_WEB_LIB:-../raylib/build_web/raylib}
+OUT=webBuild
+SIMD=""
+
+while [ $# -gt 0 ]; do
+    case "$1" in
+        --simd) SIMD="-msimd128" ;;
+        --out) OUT="$2"; shift ;;
+        *) echo "usage: $0 [--simd] [--out dir]" >&2; exit 2 ;;
+    esac
+    shift
+done
+
+# 1. Activate EMSDK environment if it isn't already
+if ! command -v em++ >/dev/null 2>&1; then
+    if [ -n "$EMSDK" ] && [ -f "$EMSDK/emsdk_env.sh" ]; then
+        . "$EMSDK/emsdk_env.sh" >/dev/null
+    else
+        echo "em++ not found, activate emsdk or set EMSDK" >&2
+        exit 1
+    fi
+fi
+
+# 2. Project folder is wherever this script is
+cd "$(dirname "$0")"
+
+# 3. Host tools
+cmake -S . -B build -DCMAKE_BUILD_TYPE=Release >/dev/null
+cmake --build build --config Release --target levelconv atlaspack
+
+# 4. Pack the level, the binary is a fraction of level.txt
+./build/levelconv level.txt level.bin
+
+# 5. Pack the sprites so the browser doesn't do it on every load
+./build/atlaspack assets
+
+# 6. Copy what the game fetches at startup (see loadJobs in main.cpp). Not
+# preloaded on purpose: the start screen shows while these download.
+mkdir -p "$OUT/assets"
+cp assets/atlas.png assets/atlas.txt assets/background.png "$OUT/assets/"
+cp level.bin "$OUT/"
+
+# 7. Compile C++ to WebAssembly. No ASYNCIFY: the frame loop is
+# emscripten_set_main_loop, so nothing has to unwind back to the browser.
+em++ main.cpp level.cpp sim.cpp replay.cpp mapfile.cpp profiler.cpp particles.cpp worker.cpp atlas.cpp loader.cpp background.cpp bloom.cpp shaders.cpp quality.cpp arena.cpp allocstats.cpp \
+    -o "$OUT/index.js" -Os $SIMD -s USE_GLFW=3 \
+    -s MODULARIZE=1 \
+    -s EXPORT_ES6 \
+    -s ALLOW_MEMORY_GROWTH=1 \
+    -DPLATFORM_WEB \
+    -I "$RAYLIB_SRC" \
+    -L "$RAYLIB_WEB_LIB" \
+    -lraylib
+
+echo
+echo "Build complete! Files in: $OUT ($(wc -c < "$OUT/index.wasm") bytes of wasm${SIMD:+, SIMD})"
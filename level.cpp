@@ -0,0 +1,350 @@
+#include "level.h"
+#include "mapfile.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+//Dis is just initializin for the loadlevel func
+int levelRows;
+int levelCols;
+
+TileGrid tileGrid;
+std::vector<LevelText> levelTexts;
+
+// The open level file and where each of its rows starts
+static FILE* levelFile = nullptr;
+static std::vector<long> rowOffset;
+static std::vector<int> rowLength;
+static std::vector<char> rowBuffer;
+
+// Or the mapped level.bin
+static MappedFile levelBin;
+static const unsigned char* binIds = nullptr;
+static const unsigned char* binPalette = nullptr;
+static int binIdBytes = 1;
+
+static TileType TileFromChar(char c) {
+    if (c == '#') return TILE_GROUND;
+    if (c == 'B') return TILE_BOX;
+    if (c == '^') return TILE_SPIKE;
+    return TILE_EMPTY;
+}
+
+static bool ParseColor(const char* s, Color& out) {
+    struct Named { const char* name; Color color; };
+    const Named names[] = {
+        { "WHITE", WHITE }, { "RED", RED }, { "YELLOW", YELLOW }, { "GREEN", GREEN },
+        { "BLUE", BLUE }, { "ORANGE", ORANGE }, { "PINK", PINK }, { "PURPLE", PURPLE },
+        { "GRAY", GRAY }, { "SKYBLUE", SKYBLUE }, { "LIME", LIME }, { "GOLD", GOLD },
+    };
+    for (const Named& n : names) {
+        if (strcmp(s, n.name) == 0) {
+            out = n.color;
+            return true;
+        }
+    }
+
+    unsigned int r, g, b, a = 255;
+    size_t len = strlen(s);
+    if (s[0] == '#' && (len == 7 || len == 9) &&
+        sscanf(s + 1, "%2x%2x%2x", &r, &g, &b) == 3 && (len == 7 || sscanf(s + 7, "%2x", &a) == 1)) {
+        out = { (unsigned char)r, (unsigned char)g, (unsigned char)b, (unsigned char)a };
+        return true;
+    }
+    return false;
+}
+
+bool ParseLevelTextLine(const char* line, LevelText& out) {
+    float x, y;
+    int size, used = 0;
+    char color[16];
+    if (sscanf(line, "@text %f %f %d %15s %n", &x, &y, &size, color, &used) != 4 || used == 0) return false;
+    if (!ParseColor(color, out.color)) return false;
+
+    out.pos = { x, y };
+    out.fontSize = size;
+    out.text = line + used;
+    while (!out.text.empty() && (out.text.back() == '\r' || out.text.back() == ' ')) out.text.pop_back();
+    return !out.text.empty();
+}
+
+static void SortLevelTexts() {
+    std::stable_sort(levelTexts.begin(), levelTexts.end(), [](const LevelText& a, const LevelText& b) {
+        return a.pos.x < b.pos.x;
+    });
+}
+
+// Unpacks columns from level.bin straight out of the mapping
+static void LoadBinaryColumns(TileGrid& grid, int first, int count) {
+    int colBytes = LevelColumnBytes(grid.rows);
+
+    for (int x = first; x < first + count; x++) {
+        int id = binIds[(size_t)x * binIdBytes];
+        if (binIdBytes == 2) id |= binIds[(size_t)x * 2 + 1] << 8;
+
+        const unsigned char* column = binPalette + (size_t)id * colBytes;
+        unsigned char* dst = &grid.cells[(size_t)(x % grid.windowCols) * grid.rows];
+        for (int y = 0; y < grid.rows; y++) {
+            dst[y] = (column[y / 4] >> ((y % 4) * 2)) & 3;
+        }
+    }
+}
+
+// Reads columns [first, first + count) of every row into their ring slots
+static void LoadColumns(TileGrid& grid, int first, int count) {
+    if (count <= 0) return;
+    if (binIds != nullptr) {
+        LoadBinaryColumns(grid, first, count);
+        return;
+    }
+    rowBuffer.resize(count);
+
+    for (int y = 0; y < grid.rows; y++) {
+        int n = 0;
+        if (levelFile != nullptr && first < rowLength[y]) {
+            n = std::min(count, rowLength[y] - first);
+            fseek(levelFile, rowOffset[y] + first, SEEK_SET);
+            n = (int)fread(rowBuffer.data(), 1, n, levelFile);
+        }
+        for (int i = 0; i < count; i++) {
+            int x = first + i;
+            TileType t = (i < n) ? TileFromChar(rowBuffer[i]) : TILE_EMPTY;
+            grid.cells[(size_t)(x % grid.windowCols) * grid.rows + y] = t;
+        }
+    }
+}
+
+void TileGrid::Init(int numRows, int numCols, int numWindowCols) {
+    rows = numRows;
+    cols = numCols;
+    windowCols = (numWindowCols <= 0 || numWindowCols > numCols) ? numCols : numWindowCols;
+    if (windowCols < 1) windowCols = 1;
+    firstCol = 0;
+    cells.assign((size_t)rows * windowCols, TILE_EMPTY);
+    LoadColumns(*this, 0, std::min(windowCols, cols));
+}
+
+void TileGrid::Scroll(float worldX) {
+    if (windowCols >= cols) return;
+
+    // A quarter of the window trails behind the player. Snapping to steps
+    // means the file gets read every few columns instead of every column.
+    int step = std::max(1, windowCols / 8);
+    int first = (int)floorf(worldX / TILE_SIZE) - windowCols / 4;
+    first = (int)floorf((float)first / step) * step;
+    first = std::max(0, std::min(first, cols - windowCols));
+    if (first == firstCol) return;
+
+    int oldFirst = firstCol;
+    firstCol = first;
+
+    // Only read the columns that weren't already resident
+    int lo = first;
+    int hi = first + windowCols;
+    if (first > oldFirst && first < oldFirst + windowCols) lo = oldFirst + windowCols;
+    else if (first < oldFirst && hi > oldFirst) hi = oldFirst;
+    LoadColumns(*this, lo, hi - lo);
+}
+
+static void PutLE(unsigned char*& p, uint32_t v, int bytes) {
+    for (int i = 0; i < bytes; i++) *p++ = (unsigned char)(v >> (8 * i));
+}
+
+static uint32_t GetLE(const unsigned char*& p, int bytes) {
+    uint32_t v = 0;
+    for (int i = 0; i < bytes; i++) v |= (uint32_t)*p++ << (8 * i);
+    return v;
+}
+
+static uint32_t FloatBits(float f) {
+    uint32_t v;
+    memcpy(&v, &f, 4);
+    return v;
+}
+
+static float BitsFloat(uint32_t v) {
+    float f;
+    memcpy(&f, &v, 4);
+    return f;
+}
+
+void PackLevelFileHeader(const LevelFileHeader& header, unsigned char* out) {
+    memcpy(out, header.magic, 4);
+    out += 4;
+    PutLE(out, header.version, 2);
+    PutLE(out, header.rows, 2);
+    PutLE(out, header.cols, 4);
+    PutLE(out, header.paletteCount, 4);
+    PutLE(out, header.idBytes, 1);
+    for (uint8_t b : header.pad) PutLE(out, b, 1);
+    PutLE(out, header.textCount, 4);
+    PutLE(out, header.textBytes, 4);
+}
+
+void UnpackLevelFileHeader(const unsigned char* in, LevelFileHeader& header) {
+    memcpy(header.magic, in, 4);
+    in += 4;
+    header.version = (uint16_t)GetLE(in, 2);
+    header.rows = (uint16_t)GetLE(in, 2);
+    header.cols = GetLE(in, 4);
+    header.paletteCount = GetLE(in, 4);
+    header.idBytes = (uint8_t)GetLE(in, 1);
+    for (uint8_t& b : header.pad) b = (uint8_t)GetLE(in, 1);
+    header.textCount = GetLE(in, 4);
+    header.textBytes = GetLE(in, 4);
+}
+
+void PackLevelTextRecord(const LevelTextRecord& rec, unsigned char* out) {
+    PutLE(out, FloatBits(rec.x), 4);
+    PutLE(out, FloatBits(rec.y), 4);
+    PutLE(out, rec.fontSize, 2);
+    PutLE(out, rec.length, 2);
+    memcpy(out, rec.color, 4);
+}
+
+void UnpackLevelTextRecord(const unsigned char* in, LevelTextRecord& rec) {
+    rec.x = BitsFloat(GetLE(in, 4));
+    rec.y = BitsFloat(GetLE(in, 4));
+    rec.fontSize = (uint16_t)GetLE(in, 2);
+    rec.length = (uint16_t)GetLE(in, 2);
+    memcpy(rec.color, in, 4);
+}
+
+// Checks the mapped file really is a level.bin before anything trusts it
+static bool OpenBinaryLevel() {
+    if (levelBin.size < LEVEL_FILE_HEADER_BYTES) return false;
+
+    LevelFileHeader header;
+    UnpackLevelFileHeader(levelBin.data, header);
+    if (memcmp(header.magic, LEVEL_FILE_MAGIC, 4) != 0 || header.version != LEVEL_FILE_VERSION) return false;
+
+    if (header.idBytes != 1 && header.idBytes != 2) return false;
+    size_t idsSize = (size_t)header.cols * header.idBytes;
+    size_t paletteSize = (size_t)header.paletteCount * LevelColumnBytes(header.rows);
+    if (levelBin.size < LEVEL_FILE_HEADER_BYTES + idsSize + paletteSize) return false;
+
+    // One bad id would read outside the palette, check them all once here
+    const unsigned char* ids = levelBin.data + LEVEL_FILE_HEADER_BYTES;
+    for (uint32_t x = 0; x < header.cols; x++) {
+        uint32_t id = ids[(size_t)x * header.idBytes];
+        if (header.idBytes == 2) id |= ids[(size_t)x * 2 + 1] << 8;
+        if (id >= header.paletteCount) return false;
+    }
+
+    // Texts are few, copy them out so nothing keeps pointing into the file
+    const unsigned char* text = ids + idsSize + paletteSize;
+    const unsigned char* textEnd = text + header.textBytes;
+    if (levelBin.size < LEVEL_FILE_HEADER_BYTES + idsSize + paletteSize + header.textBytes) return false;
+    for (uint32_t i = 0; i < header.textCount; i++) {
+        LevelTextRecord rec;
+        if (textEnd - text < (long)LEVEL_TEXT_RECORD_BYTES) return false;
+        UnpackLevelTextRecord(text, rec);
+        text += LEVEL_TEXT_RECORD_BYTES;
+        if (textEnd - text < rec.length) return false;
+
+        LevelText t;
+        t.pos = { rec.x, rec.y };
+        t.fontSize = rec.fontSize;
+        t.color = { rec.color[0], rec.color[1], rec.color[2], rec.color[3] };
+        t.text.assign((const char*)text, rec.length);
+        levelTexts.push_back(t);
+        text += rec.length;
+    }
+    SortLevelTexts();
+
+    binIds = ids;
+    binIdBytes = header.idBytes;
+    binPalette = ids + idsSize;
+    levelRows = header.rows;
+    levelCols = (int)header.cols;
+    return true;
+}
+
+static void ParseLevelData(const std::string& line) {
+    LevelText t;
+    if (line.compare(0, 6, "@text ") == 0 && ParseLevelTextLine(line.c_str(), t)) levelTexts.push_back(t);
+    else TraceLog(LOG_WARNING, "Skipping level line: %s", line.c_str());
+}
+
+void LoadLevelFromFile(const char* filename) {
+    if (levelFile != nullptr) fclose(levelFile);
+    levelFile = nullptr;
+    UnmapFile(levelBin);
+    binIds = nullptr;
+    binPalette = nullptr;
+    rowOffset.clear();
+    rowLength.clear();
+    levelTexts.clear();
+    levelRows = 0;
+    levelCols = 0;
+
+    // Binary so the offsets are real byte offsets on Windows too
+    levelFile = fopen(filename, "rb");
+    if (levelFile == NULL) {
+        TraceLog(LOG_ERROR, "Could not open level file!");
+        return;
+    }
+
+    char magic[4] = {};
+    if (fread(magic, 1, 4, levelFile) == 4 && memcmp(magic, LEVEL_FILE_MAGIC, 4) == 0) {
+        fclose(levelFile);
+        levelFile = nullptr;
+        if (!MapFile(filename, levelBin) || !OpenBinaryLevel()) {
+            UnmapFile(levelBin);
+            levelTexts.clear();
+            levelRows = 0;
+            levelCols = 0;
+            TraceLog(LOG_ERROR, "Level file %s is not a valid level.bin!", filename);
+        }
+        return;
+    }
+    fseek(levelFile, 0, SEEK_SET);
+
+    // One pass over the file in blocks, any row length works. Lines
+    // starting with @ are level data and get parsed instead of indexed.
+    char block[4096];
+    long offset = 0;
+    long rowStart = 0;
+    char prev = '\n';
+    bool dataLine = false;
+    std::string data;
+    size_t got;
+    while ((got = fread(block, 1, sizeof(block), levelFile)) > 0) {
+        for (size_t i = 0; i < got; i++, offset++) {
+            char c = block[i];
+            if (prev == '\n') dataLine = (c == '@');
+
+            if (c == '\n') {
+                if (dataLine) {
+                    ParseLevelData(data);
+                    data.clear();
+                } else {
+                    // Drop the \r of a CRLF line ending
+                    int len = (int)(offset - rowStart) - (prev == '\r' ? 1 : 0);
+                    rowOffset.push_back(rowStart);
+                    rowLength.push_back(len);
+                }
+                rowStart = offset + 1;
+            } else if (dataLine) {
+                data += c;
+            }
+            prev = c;
+        }
+    }
+    if (prev != '\n') {
+        if (dataLine) {
+            ParseLevelData(data);
+        } else {
+            rowOffset.push_back(rowStart);
+            rowLength.push_back((int)(offset - rowStart) - (prev == '\r' ? 1 : 0));
+        }
+    }
+    SortLevelTexts();
+
+    levelRows = rowOffset.size();
+    for (int len : rowLength) levelCols = std::max(levelCols, len);
+}
+
+void LoadLevel(int windowCols) {
+    tileGrid.Init(levelRows, levelCols, windowCols);
+}
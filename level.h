@@ -0,0 +1,129 @@
+#pragma once
+
+#include "raylib.h"
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdint>
+
+const int TILE_SIZE = 40;
+
+// What a level cell holds, as far as collision cares
+enum TileType : unsigned char { TILE_EMPTY = 0, TILE_GROUND, TILE_BOX, TILE_SPIKE };
+
+// level.bin, written by tools/levelconv from level.txt. Little-endian, laid
+// out so the loader can use it straight from the mapped file:
+//   LevelFileHeader
+//   column ids           cols entries of idBytes (1, or 2 past 256 distinct
+//                        columns), which palette entry each column is
+//   column palette       paletteCount columns of LevelColumnBytes(rows)
+//                        bytes, 2 bits per tile, row 0 in the low bits
+//   texts                textCount LevelTextRecords, each followed by its
+//                        `length` bytes of text (textBytes in total)
+// Levels reuse the same few columns over and over, so that is about a byte
+// per column instead of a byte per tile.
+const char LEVEL_FILE_MAGIC[4] = { 'C', 'D', 'L', 'V' };
+const uint16_t LEVEL_FILE_VERSION = 2;
+
+struct LevelFileHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t rows;
+    uint32_t cols;
+    uint32_t paletteCount;
+    uint8_t idBytes;
+    uint8_t pad[3];
+    uint32_t textCount;
+    uint32_t textBytes;
+};
+
+struct LevelTextRecord {
+    float x, y;
+    uint16_t fontSize;
+    uint16_t length;
+    uint8_t color[4];
+};
+
+// The two structs above are the decoded form. On disk each field is stored
+// little-endian in the order declared, pad included, with nothing between
+// them; these convert so the file reads the same on any host.
+const size_t LEVEL_FILE_HEADER_BYTES = 28;
+const size_t LEVEL_TEXT_RECORD_BYTES = 16;
+void PackLevelFileHeader(const LevelFileHeader& header, unsigned char* out);
+void UnpackLevelFileHeader(const unsigned char* in, LevelFileHeader& header);
+void PackLevelTextRecord(const LevelTextRecord& rec, unsigned char* out);
+void UnpackLevelTextRecord(const unsigned char* in, LevelTextRecord& rec);
+
+inline int LevelColumnBytes(int rows) { return (rows + 3) / 4; }
+
+// Columns of the level that can be resident at once while streaming. Enough
+// to cover the screen plus a chunk either side, with room to spare.
+const int LEVEL_WINDOW_COLS = 128;
+
+// Column-major window onto the level grid so collision only has to look at
+// the few cells around the player instead of every tile in the level.
+// Only `windowCols` columns live in memory, in a ring: column x sits in slot
+// x % windowCols. Scroll() recycles the slots that fell behind for the
+// columns coming up, so memory stays the same however long the level is.
+// Cells outside the window read as empty.
+struct TileGrid {
+    int rows = 0;
+    int cols = 0;       // columns in the whole level
+    int windowCols = 0; // columns resident at once
+    int firstCol = 0;   // first resident column
+    std::vector<unsigned char> cells; // cells[slot * rows + y], one column is contiguous
+
+    void Init(int numRows, int numCols, int numWindowCols);
+
+    // Moves the window so it covers worldX, reading the new columns from the
+    // level file. Does nothing when the whole level is resident.
+    void Scroll(float worldX);
+
+    TileType At(int x, int y) const {
+        if (x < firstCol || y < 0 || x >= firstCol + windowCols || x >= cols || y >= rows) return TILE_EMPTY;
+        return (TileType)cells[(size_t)(x % windowCols) * rows + y];
+    }
+
+    Rectangle CellRect(int x, int y) const {
+        return { (float)x * TILE_SIZE, (float)y * TILE_SIZE, TILE_SIZE, TILE_SIZE };
+    }
+
+    // Inclusive cell range a rect touches, grown by `margin` cells on every side
+    void CellRange(Rectangle r, int margin, int& x0, int& y0, int& x1, int& y1) const {
+        x0 = (int)floorf(r.x / TILE_SIZE) - margin;
+        y0 = (int)floorf(r.y / TILE_SIZE) - margin;
+        x1 = (int)floorf((r.x + r.width) / TILE_SIZE) + margin;
+        y1 = (int)floorf((r.y + r.height) / TILE_SIZE) + margin;
+    }
+};
+
+// A label placed in the world. In level.txt it's a line like
+//   @text 1400 500 20 RED Hit a Spike?... Well
+// (x, y, font size, color name or #RRGGBB[AA], then the text). Lines that
+// start with @ are level data, not tile rows, and can go anywhere.
+struct LevelText {
+    Vector2 pos;
+    int fontSize;
+    Color color;
+    std::string text;
+};
+
+extern std::vector<LevelText> levelTexts; // sorted by x
+
+bool ParseLevelTextLine(const char* line, LevelText& out);
+
+// Size of the last level file indexed. Rows can be any length, the level is
+// as wide as its longest row.
+extern int levelRows;
+extern int levelCols;
+
+extern TileGrid tileGrid;
+
+// Opens a level, level.txt or level.bin (told apart by the header). Text gets
+// indexed by where every row starts, binary gets memory-mapped. Either way
+// tiles are read a window at a time by TileGrid::Scroll().
+void LoadLevelFromFile(const char* filename);
+
+// Sets tileGrid up at the start of the level, from the level already open. Needs no window, the headless
+// tools use it too. windowCols = 0 keeps the whole level resident.
+void LoadLevel(int windowCols = LEVEL_WINDOW_COLS);
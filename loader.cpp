@@ -0,0 +1,155 @@
+#include "loader.h"
+#include "raylib.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(PLATFORM_WEB) || defined(__EMSCRIPTEN__)
+#include <emscripten/emscripten.h>
+#include <sys/stat.h>
+#endif
+
+static const LoadJob* jobs = nullptr;
+static int jobCount = 0;
+static int gpuDone = 0;                  // jobs fully loaded, main thread only
+static std::atomic<int> cpuDone(0);      // jobs whose CPU part has run
+static std::atomic<bool> cancelled(false);
+static std::thread loaderThread;
+
+#if defined(PLATFORM_WEB) || defined(__EMSCRIPTEN__)
+// One entry per file of every job, filled in by the fetch callbacks
+struct Fetch {
+    int job;
+    int percent = 0;
+    bool done = false;
+};
+static std::vector<Fetch> fetches;
+static std::string fetchError;
+
+static void OnFetched(unsigned, void* arg, const char*) {
+    Fetch& f = fetches[(size_t)arg];
+    f.percent = 100;
+    f.done = true;
+}
+
+static void OnFetchError(unsigned, void* arg, int status) {
+    Fetch& f = fetches[(size_t)arg];
+    f.done = true; // the job still runs and finds the file missing, same as desktop
+    fetchError = TextFormat("HTTP %d", status);
+}
+
+static void OnFetchProgress(unsigned, void* arg, int percent) {
+    fetches[(size_t)arg].percent = percent;
+}
+
+// MEMFS needs the directories before a file can land in them
+static void MakeParentDirs(const std::string& path) {
+    for (size_t slash = path.find('/'); slash != std::string::npos; slash = path.find('/', slash + 1)) {
+        mkdir(path.substr(0, slash).c_str(), 0777);
+    }
+}
+
+static void StartFetches() {
+    fetches.clear();
+    for (int j = 0; j < jobCount; j++) {
+        for (int f = 0; f < LOAD_MAX_FILES && jobs[j].files[f] != nullptr; f++) {
+            Fetch fetch;
+            fetch.job = j;
+            fetches.push_back(fetch);
+        }
+    }
+
+    size_t i = 0;
+    for (int j = 0; j < jobCount; j++) {
+        for (int f = 0; f < LOAD_MAX_FILES && jobs[j].files[f] != nullptr; f++, i++) {
+            MakeParentDirs(jobs[j].files[f]);
+            emscripten_async_wget2(jobs[j].files[f], jobs[j].files[f], "GET", "", (void*)i,
+                                   OnFetched, OnFetchError, OnFetchProgress);
+        }
+    }
+}
+
+static bool JobFilesReady(int job) {
+    for (const Fetch& f : fetches) {
+        if (f.job == job && !f.done) return false;
+    }
+    return true;
+}
+#endif
+
+void StartLoading(const LoadJob* list, int count, bool threaded) {
+    jobs = list;
+    jobCount = count;
+    gpuDone = 0;
+    cpuDone = 0;
+    cancelled = false;
+
+#if defined(PLATFORM_WEB) || defined(__EMSCRIPTEN__)
+    (void)threaded;
+    StartFetches();
+#else
+    if (threaded) {
+        loaderThread = std::thread([]() {
+            for (int j = 0; j < jobCount && !cancelled; j++) {
+                jobs[j].cpu();
+                cpuDone++;
+            }
+        });
+    }
+#endif
+}
+
+bool UpdateLoading() {
+    if (gpuDone == jobCount) return true;
+
+    if (!loaderThread.joinable()) {
+        // Cooperative: one job per frame so the screen keeps updating
+#if defined(PLATFORM_WEB) || defined(__EMSCRIPTEN__)
+        if (!JobFilesReady(gpuDone)) return false;
+#endif
+        jobs[gpuDone].cpu();
+        cpuDone++;
+    }
+
+    // Uploads for whatever the loader thread has finished
+    while (gpuDone < cpuDone) {
+        if (jobs[gpuDone].gpu != nullptr) jobs[gpuDone].gpu();
+        gpuDone++;
+    }
+
+    if (gpuDone == jobCount) {
+        if (loaderThread.joinable()) loaderThread.join();
+        return true;
+    }
+    return false;
+}
+
+float LoadingProgress() {
+    if (jobCount == 0) return 1.0f;
+    float done = (float)gpuDone;
+#if defined(PLATFORM_WEB) || defined(__EMSCRIPTEN__)
+    // Downloads are most of the wait on web, count them in
+    int files = 0, percent = 0;
+    for (const Fetch& f : fetches) {
+        if (f.job != gpuDone) continue;
+        files++;
+        percent += f.percent;
+    }
+    if (files > 0 && gpuDone < jobCount) done += 0.9f * percent / (100.0f * files);
+#endif
+    return done / jobCount;
+}
+
+const char* LoadingStatus() {
+    if (gpuDone == jobCount) return "Ready";
+#if defined(PLATFORM_WEB) || defined(__EMSCRIPTEN__)
+    if (!fetchError.empty()) return TextFormat("Loading %s... (%s)", jobs[gpuDone].name, fetchError.c_str());
+#endif
+    return TextFormat("Loading %s...", jobs[gpuDone].name);
+}
+
+void StopLoading() {
+    cancelled = true;
+    if (loaderThread.joinable()) loaderThread.join();
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+// Startup loading in steps, so the start screen draws from the first frame
+// instead of after everything is in. Each job has a CPU part (file reads,
+// image decoding, level parsing; safe off the main thread, no GL) and a GPU
+// part (texture uploads and anything else that needs the window) that always
+// runs on the main thread.
+//  - Desktop: a loader thread runs the CPU parts in order, UpdateLoading()
+//    picks up the finished ones and uploads them.
+//  - Web: no threads. Files aren't preloaded either, they get fetched in the
+//    background, and UpdateLoading() runs one job per frame once its files
+//    are there.
+const int LOAD_MAX_FILES = 4;
+
+struct LoadJob {
+    const char* name;                   // what the loading bar says
+    const char* files[LOAD_MAX_FILES];  // fetched first on web, null-terminated
+    void (*cpu)();                      // any thread
+    void (*gpu)();                      // main thread, after cpu (can be null)
+};
+
+void StartLoading(const LoadJob* jobs, int count, bool threaded);
+
+// Once a frame on the main thread. Returns true once every job is done.
+bool UpdateLoading();
+
+float LoadingProgress(); // 0..1
+const char* LoadingStatus();
+
+// Waits for the loader thread (e.g. the window got closed mid-load)
+void StopLoading();
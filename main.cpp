@@ -1,18 +1,32 @@
 #include "raylib.h"
+#include "rlgl.h"
+#include "level.h"
+#include "sim.h"
+#include "replay.h"
+#include "profiler.h"
+#include "particles.h"
+#include "worker.h"
+#include "atlas.h"
+#include "loader.h"
+#include "background.h"
+#include "bloom.h"
+#include "quality.h"
+#include "arena.h"
+#include "allocstats.h"
 #include <vector>
+#include <algorithm>
 #include <cstring>
 #include <string>
 #include "cmath"
 #include <cstdio>
 #include <cstdlib>
+#if defined(PLATFORM_WEB) || defined(__EMSCRIPTEN__)
+#include <emscripten/emscripten.h>
+#endif
 
 
 //TEXTURESSSS
-Texture2D playerTexture;
-Texture2D floorTexture;
-Texture2D backgroundTexture;
-Texture2D boxTexture;
-Texture2D spikeTexture;
+// Sprites are all in `atlas` (atlas.h), the background in `background` (background.h)
 
 // === COLOR SCHEME ===
 // Spikes & Obstacles
@@ -52,381 +66,788 @@ Color trailTintDown    = { 100, 255, 200, 220 }; // Aqua-mint trail
 
 //Constants i suppose
 
-bool wasGroundedLastFrame = true;
-float shakeDuration = 0.0f;
-float gameOverTimer = 0.0f;
 const float gameOverDelay = 2.0f; 
 const float shakeMagnitude = 2.0f;
-const float gravity = 0.8f;
-const float jumpForce = 12.0f;
-const int groundY = 640;
-const int ceilingY = 80;
-const Vector2 restartPosition = { 400, groundY - 40 };
-const float scrollSpeed = 4.0f;
 
-Vector2 shakeOffset = { 0, 0 };
-
-//Screen dimensions
-const int screenWidth = 1280;
-const int screenHeight =720;
-const int TILE_SIZE = 40;
-
-
-std::vector<std::string> level;
-
-//Dis is just initializin for the loadlevel func
-int levelRows;
-int levelCols;
+// Simulation runs in fixed SIM_DT ticks (see sim.h), drawing interpolates
+const float MAX_FRAME_TIME = 0.25f; // don't try to catch up after huge hitches
 
 //Game states 
 enum GameState { START, PLAYING, GAMEOVER, VICTORY };
 GameState gameState = START;
 
-class Particle {
-public:
-    Vector2 position;
-    Vector2 velocity;
-    float size;
-    float lifetime;     // remaining
-    float maxLifetime;  // initial
-    Color color;
-    bool additive; 
+ParticleSystem particles;
 
-    Particle(Vector2 pos, Vector2 vel, float s, float life, Color col, bool add = false)
-        : position(pos), velocity(vel), size(s), lifetime(life), maxLifetime(life), color(col), additive(add) {}
 
-    void Update(float dt) {
-        position.x += velocity.x * dt;
-        position.y += velocity.y * dt;
-        lifetime   -= dt;
+// Dust and sparks kicked up when the player jumps off the floor
+void SpawnJumpParticles(Vector2 foot, int gravityDirection) {
+    int dust = QualityCount(12), sparks = QualityCount(5);
+    for (int i = 0; i < dust; ++i) {
+        float baseDeg   = (gravityDirection == 1) ? -90.0f : 90.0f;
+        float spreadDeg = (float)GetRandomValue(-70, 70);
+        float ang       = (baseDeg + spreadDeg) * DEG2RAD;
+        float speed     = 140.0f + (float)GetRandomValue(0, 70);
+        Vector2 vel     = { cosf(ang) * speed, sinf(ang) * speed };
+
+        float sz   = 4.0f + (float)GetRandomValue(0, 15) * 0.1f;
+        float life = 0.2f + (float)GetRandomValue(0, 8) * 0.01f;
+        particles.Spawn(foot, vel, sz, life, dustJumpTint, false);
     }
 
-    void Draw() const {
-        float t = (maxLifetime > 0.0f) ? (lifetime / maxLifetime) : 0.0f;
-        if (t < 0.0f) t = 0.0f; 
-        if (t > 1.0f) t = 1.0f;
-        Color c = color;
-        c.a = (unsigned char)(color.a * t);  
-        float r = size * (0.5f + 0.5f * t); 
-        DrawCircleV(position, r, c);
+    Color sparkTint = (gravityDirection == 1) ? sparkUpTint : sparkDownTint;
+    for (int i = 0; i < sparks; ++i) {
+        float baseDeg   = (gravityDirection == 1) ? -90.0f : 90.0f;
+        float spreadDeg = (float)GetRandomValue(-40, 40);
+        float ang       = (baseDeg + spreadDeg) * DEG2RAD;
+        float speed     = 220.0f + (float)GetRandomValue(0, 120);
+        Vector2 vel     = { cosf(ang) * speed, sinf(ang) * speed };
+
+        float sz   = 4.0f + (float)GetRandomValue(0, 8) * 0.1f;
+        float life = 0.12f + (float)GetRandomValue(0, 10) * 0.01f;
+        particles.Spawn(foot, vel, sz, life, sparkTint, true);
     }
+}
 
-    bool IsAlive() const { return lifetime > 0.0f; }
-    bool IsDead()  const { return lifetime <= 0.0f; }
-};
+// alpha = how far we are between the previous tick and the current one
+void DrawPlayer(const Player& p, float alpha = 1.0f) {
+    PROFILE_SCOPE("DrawPlayer");
+    Vector2 at = p.RenderPos(alpha);
+    float angle = p.prevRotation + (p.rotation - p.prevRotation) * alpha;
+    Vector2 origin = { p.width / 2, p.height / 2 };
+    Vector2 center = { at.x + p.width / 2, at.y + p.height / 2 };
+    Color tint = (at.y + p.height / 2 < GetScreenHeight() / 2) ? playerDownTint : playerUpTint;
+    DrawSprite(SPRITE_PLAYER, { center.x, center.y, p.width, p.height }, origin, angle, tint);
+}
+
+// Player trail: the last few positions in a fixed ring, oldest overwritten
+// first. `length` and `sampleEvery` can be changed at runtime, up to
+// TRAIL_CAPACITY points.
+const int TRAIL_CAPACITY = 128;
+
+struct Trail {
+    Vector2 points[TRAIL_CAPACITY];
+    int head = 0;        // next slot to write
+    int count = 0;       // valid points in the ring
+    int length = 20;     // points actually drawn
+    int sampleEvery = 1; // ticks between samples
+    int ticksSinceSample = 0;
+
+    void Clear() {
+        head = 0;
+        count = 0;
+        ticksSinceSample = 0;
+    }
+
+    // Call once per tick
+    void Push(Vector2 p) {
+        if (++ticksSinceSample < sampleEvery) return;
+        ticksSinceSample = 0;
+
+        points[head] = p;
+        head = (head + 1) % TRAIL_CAPACITY;
+        if (count < TRAIL_CAPACITY) count++;
+    }
 
-std::vector<Particle> particles;
+    int Size() const {
+        return std::min(count, std::min(length, TRAIL_CAPACITY));
+    }
 
+    // 0 is the oldest point that is still drawn
+    Vector2 Get(int i) const {
+        int idx = head - Size() + i;
+        if (idx < 0) idx += TRAIL_CAPACITY;
+        return points[idx];
+    }
+};
 
-class Player{
-public:
-    Vector2 pos;
+// Everything one attempt changes. The level is read-only, so restarting is
+// `run = RunState()` and a practice respawn is copying a checkpoint back, no
+// allocation. The tile window does get re-streamed from the level file around
+// the new position (tileGrid.Scroll) unless the whole level is resident.
+// Particles are just eye candy and get cleared.
+struct RunState {
+    SimState sim;
+    Trail trail;
+    Camera2D camera = { { screenWidth/2.0f, screenHeight/2.0f }, { restartPosition.x + screenWidth/4, screenHeight/2.0f }, 0.0f, 1.0f };
+    float shakeDuration = 0.0f;
+    Vector2 shakeOffset = { 0, 0 };
+    float gameOverTimer = 0.0f;
+    float simAccumulator = 0.0f;
+    bool jumpQueued = false;
+};
 
-    int gravityDirection = 1;
+RunState run;
+SimState& sim = run.sim;
+Player& p1 = run.sim.player;
+Trail& trail = run.trail;
+Camera2D& camera = run.camera;
+
+// Practice mode: dying puts you back on the last checkpoint instead of the
+// game over screen. One gets dropped every CHECKPOINT_INTERVAL seconds while
+// on the floor, Z places one by hand and X takes the last one away.
+const int MAX_CHECKPOINTS = 64;
+const float CHECKPOINT_INTERVAL = 2.0f;
+bool practiceMode = false;
+std::vector<RunState> checkpoints; // reserved up front, oldest dropped when full
+int ticksSinceCheckpoint = 0;
+
+// --record <file>: every finished run gets written there as a replay
+const char* recordPath = nullptr;
+Replay recording;
+bool recordingValid = true; // debug cheats make a run unreplayable
+
+// On desktop the PLAYING state runs as a two stage pipeline: a worker thread
+// simulates frame N+1 (ticks, particles, shake) while the main thread submits
+// the draw calls for frame N. Drawing only ever reads a RenderSnapshot, a
+// copy of everything it needs taken at the end of the sim job. There are two
+// of them, the worker fills one while the main thread draws the other, and
+// they swap once a frame after Wait(). Costs one frame of display latency.
+// The tile window is only scrolled by the main thread while the worker is
+// idle, chunk baking reads it during the draw.
+// Web has no threads, there the same steps just run one after the other.
+struct FrameInput {
+    float dt = 0.0f;
+    bool jump = false;
+    bool placeCheckpoint = false;
+    bool removeCheckpoint = false;
+    bool cheatFlip = false;
+    bool cheatForward = false;
+};
 
-    float width = TILE_SIZE - 10, height = TILE_SIZE - 10;
-    float velocityX = 0 , velocityY= 0;
-    float rotation = 0.0f;
-    float targetRotation = 0.0f;
-    float rotationSpeed = 6.0f;
+struct RenderSnapshot {
+    Player player = Player(restartPosition.x, restartPosition.y);
+    float alpha = 0.0f; // how far into the current tick, see DrawPlayer
+    Camera2D camera = { 0 };
+    Vector2 shakeOffset = { 0, 0 };
+    Trail trail;
+    ParticleSystem particles; // Init()'d up front, only live particles get copied
+    Vector2 checkpoints[MAX_CHECKPOINTS];
+    int checkpointCount = 0;
+};
 
-    bool rotating = false;
-    bool isGrounded = false;
+RenderSnapshot snapshots[2];
+int simBack = 0;          // snapshot the sim job writes, the other one gets drawn
+FrameInput simInput;      // what the kicked job works from
+bool simPending = false;  // a job was kicked and hasn't been picked up yet
+FrameWorker simWorker;
+#if defined(PLATFORM_WEB) || defined(__EMSCRIPTEN__)
+bool useSimWorker = false;
+#else
+bool useSimWorker = true; // --no-threads turns it off
+#endif
+
+// Tiles are drawn in chunks of CHUNK_COLS columns, and only the chunks the
+// camera can see get submitted, so draw calls scale with the screen width
+// instead of with how long the level is.
+const int CHUNK_COLS = 16;
+
+// World-space rectangle a 2D camera currently covers
+Rectangle GetCameraView(const Camera2D& cam) {
+    float w = screenWidth / cam.zoom;
+    float h = screenHeight / cam.zoom;
+    return { cam.target.x - cam.offset.x / cam.zoom, cam.target.y - cam.offset.y / cam.zoom, w, h };
+}
 
-    Player(float x, float y){
-        pos = { x,y };
+void DrawTile(TileType type, Rectangle dst) {
+    if (type == TILE_GROUND) {
+        float centerY = dst.y + dst.height / 2;
+        Color tint = (centerY < screenHeight / 2) ? floorDownTint : floorUpTint;
+        DrawSprite(SPRITE_FLOOR, dst, { 0, 0 }, 0.0f, tint);
+    }
+    else if (type == TILE_BOX) {
+        DrawSprite(SPRITE_BOX, dst, { 0, 0 }, 0.0f, boxTint, dst.y < screenHeight / 2);
+    }
+    else if (type == TILE_SPIKE) {
+        DrawSprite(SPRITE_SPIKE, dst, { 0, 0 }, 0.0f, spikeTint, dst.y < screenHeight / 2);
     }
+}
 
-    void Update(){
-        if (pos.y + height / 2 < screenHeight / 2) {
-            gravityDirection = -1;
-        } else {
-            gravityDirection = 1;
-        }
+// Draws every tile inside a chunk. All tile sprites are in the atlas, so
+// this is one batch whatever the mix of tiles.
+void DrawChunkTiles(int chunk) {
+    int firstCol = chunk * CHUNK_COLS;
+    int lastCol = std::min(firstCol + CHUNK_COLS, tileGrid.cols);
 
-        velocityY += gravity * gravityDirection;
-        pos.y += velocityY;
-        if (rotating) {
-            if (fabs(rotation - targetRotation) > 0.1f) {
-            float dir = (rotation < targetRotation) ? 1 : -1;
-            rotation += dir * rotationSpeed;
-        } else {
-            rotation = targetRotation;
-            rotating = false;
-        }
+    for (int x = firstCol; x < lastCol; x++) {
+        for (int y = 0; y < tileGrid.rows; y++) {
+            TileType type = tileGrid.At(x, y);
+            if (type != TILE_EMPTY) DrawTile(type, tileGrid.CellRect(x, y));
         }
-
     }
+}
 
-    void Jump() {
-        if (isGrounded) {
-            velocityY = -jumpForce * gravityDirection;
-            targetRotation += 90.0f;
-            rotating = true;
-            isGrounded = false;
+// Chunk range [first, last] the camera can see (empty when first > last)
+void GetVisibleChunks(const Camera2D& cam, int& first, int& last) {
+    Rectangle view = GetCameraView(cam);
+    float chunkWidth = (float)(CHUNK_COLS * TILE_SIZE);
+    int chunkCount = (tileGrid.cols + CHUNK_COLS - 1) / CHUNK_COLS;
 
-            Vector2 foot = { pos.x + width * 0.5f, (gravityDirection == 1) ? (pos.y + height) : pos.y };
+    first = std::max((int)floorf(view.x / chunkWidth), 0);
+    last = std::min((int)floorf((view.x + view.width) / chunkWidth), chunkCount - 1);
+}
 
-            for (int i = 0; i < 12; ++i) {
-                float baseDeg   = (gravityDirection == 1) ? -90.0f : 90.0f;
-                float spreadDeg = (float)GetRandomValue(-70, 70);
-                float ang       = (baseDeg + spreadDeg) * DEG2RAD;
-                float speed     = 140.0f + (float)GetRandomValue(0, 70);
-                Vector2 vel     = { cosf(ang) * speed, sinf(ang) * speed };
+// Nothing in a chunk ever moves, so each visible chunk gets drawn once into a
+// render texture with its tints already applied and is then just one quad per
+// frame. Only a few slots exist; they get recycled as chunks scroll past, so
+// the VRAM used doesn't depend on the level length either. The slots sit side
+// by side in one render texture, so all visible chunks are a single batch.
+const int CHUNK_CACHE_SLOTS = 4;
 
-                float sz   = 4.0f + (float)GetRandomValue(0, 15) * 0.1f;
-                float life = 0.2f + (float)GetRandomValue(0, 8) * 0.01f;
-                particles.push_back(Particle(foot, vel, sz, life, dustJumpTint, false));
-            }
+struct ChunkSlot {
+    int chunk = -1;
+    unsigned int lastUsed = 0;
+};
 
-            Color sparkTint = (gravityDirection == 1) ? sparkUpTint : sparkDownTint;
-            for (int i = 0; i < 5; ++i) {
-                float baseDeg   = (gravityDirection == 1) ? -90.0f : 90.0f;
-                float spreadDeg = (float)GetRandomValue(-40, 40);
-                float ang       = (baseDeg + spreadDeg) * DEG2RAD;
-                float speed     = 220.0f + (float)GetRandomValue(0, 120);
-                Vector2 vel     = { cosf(ang) * speed, sinf(ang) * speed };
-
-                float sz   = 4.0f + (float)GetRandomValue(0, 8) * 0.1f;
-                float life = 0.12f + (float)GetRandomValue(0, 10) * 0.01f;
-                particles.push_back(Particle(foot, vel, sz, life, sparkTint, true));
-            }
-        }
+ChunkSlot chunkCache[CHUNK_CACHE_SLOTS];
+RenderTexture2D chunkTarget = { 0 }; // CHUNK_CACHE_SLOTS chunks wide
+unsigned int chunkCacheFrame = 0;
+
+void UnloadChunkCache() {
+    if (chunkTarget.id != 0) UnloadRenderTexture(chunkTarget);
+    chunkTarget = { 0 };
+    for (auto& slot : chunkCache) slot = ChunkSlot();
+}
+
+ChunkSlot* FindBakedChunk(int chunk) {
+    for (auto& slot : chunkCache) {
+        if (slot.chunk == chunk) return &slot;
     }
+    return nullptr;
+}
 
+// Premultiplied alpha with proper coverage: translucent tints would get their
+// alpha applied twice on screen otherwise. Draw the result with
+// BLEND_ALPHA_PREMULTIPLY and a flipped source rect.
+void BeginPremultipliedBlend() {
+    rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA, RL_FUNC_ADD, RL_FUNC_ADD);
+    BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+}
 
+void BeginPremultipliedTexture(RenderTexture2D target) {
+    BeginTextureMode(target);
+    ClearBackground(BLANK);
+    BeginPremultipliedBlend();
+}
 
+void EndPremultipliedTexture() {
+    EndBlendMode();
+    EndTextureMode();
+}
 
-    void Draw() {
-        Vector2 origin = { width / 2, height / 2 };
-        Vector2 center = { pos.x + width / 2, pos.y + height / 2 };
-        Color tint = (pos.y + height / 2 < GetScreenHeight() / 2) ? playerDownTint : playerUpTint;
-        DrawTexturePro(playerTexture,{0, 0, (float)playerTexture.width, (float)playerTexture.height},{ center.x, center.y, width, height }, origin, rotation, tint);
+void BakeChunk(ChunkSlot& slot, int chunk) {
+    int w = CHUNK_COLS * TILE_SIZE;
+    int h = tileGrid.rows * TILE_SIZE;
+    if (chunkTarget.id == 0 || chunkTarget.texture.width != w * CHUNK_CACHE_SLOTS || chunkTarget.texture.height != h) {
+        UnloadChunkCache();
+        chunkTarget = LoadRenderTexture(w * CHUNK_CACHE_SLOTS, h);
     }
+    int slotX = (int)(&slot - chunkCache) * w;
 
+    Camera2D bakeCam = { 0 };
+    bakeCam.offset = { (float)slotX, 0.0f };
+    bakeCam.target = { (float)(chunk * w), 0.0f };
+    bakeCam.zoom = 1.0f;
 
-    Rectangle GetRect(){
-        return { pos.x, pos.y, width, height};
-    }
+    // The scissor keeps the clear (and any overhang) inside this slot
+    BeginTextureMode(chunkTarget);
+    BeginScissorMode(slotX, 0, w, h);
+    ClearBackground(BLANK);
+    BeginPremultipliedBlend();
+    BeginMode2D(bakeCam);
 
-};
+    DrawChunkTiles(chunk);
 
-class Spike{
-public:
-    Vector2 pos;
-    float size = TILE_SIZE;
+    EndMode2D();
+    EndBlendMode();
+    EndScissorMode();
+    EndTextureMode();
 
-    Spike(float x, float y){
-        pos = { x,y };
-    }
+    slot.chunk = chunk;
+}
 
-    void Update(float speed){
-        pos.x -= speed;
+// Bakes whatever visible chunk isn't cached yet. Has to run outside
+// BeginMode2D since texture mode resets the camera transform.
+void BakeVisibleChunks(const Camera2D& cam) {
+    PROFILE_SCOPE("BakeVisibleChunks");
+    int first, last;
+    GetVisibleChunks(cam, first, last);
+    chunkCacheFrame++;
+
+    for (int c = first; c <= last; c++) {
+        ChunkSlot* slot = FindBakedChunk(c);
+        if (slot == nullptr) {
+            // Least recently used slot that isn't on screen this frame
+            for (auto& candidate : chunkCache) {
+                if (candidate.lastUsed == chunkCacheFrame) continue;
+                if (slot == nullptr || candidate.lastUsed < slot->lastUsed) slot = &candidate;
+            }
+            if (slot == nullptr) continue; // more chunks visible than slots, drawn directly
+            BakeChunk(*slot, c);
+        }
+        slot->lastUsed = chunkCacheFrame;
     }
+}
 
-    void Draw() {
-        Rectangle src = {0, 0, (float)spikeTexture.width, (float)spikeTexture.height};
-        Rectangle dst = GetRect();
-        if (dst.y < screenHeight / 2) src.height = -src.height;
-        DrawTexturePro(spikeTexture, src, dst, {0,0}, 0, spikeTint);
+// Call inside BeginMode2D(cam), after BakeVisibleChunks(cam)
+void DrawLevelTiles(const Camera2D& cam) {
+    PROFILE_SCOPE("DrawLevelTiles");
+    int first, last;
+    GetVisibleChunks(cam, first, last);
+    float w = (float)(CHUNK_COLS * TILE_SIZE);
+    float h = (float)chunkTarget.texture.height;
+
+    BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+    for (int c = first; c <= last; c++) {
+        ChunkSlot* slot = FindBakedChunk(c);
+        if (slot == nullptr) continue;
+        // Render textures come out upside down
+        Rectangle src = { (slot - chunkCache) * w, 0, w, -h };
+        Rectangle dst = { c * w, 0, w, h };
+        DrawTexturePro(chunkTarget.texture, src, dst, { 0, 0 }, 0.0f, WHITE);
     }
+    EndBlendMode();
 
-    Rectangle GetRect(){
-        return { pos.x, pos.y, size, size };
+    // Chunks that didn't get a slot
+    for (int c = first; c <= last; c++) {
+        if (FindBakedChunk(c) == nullptr) DrawChunkTiles(c);
     }
-};
+}
+
+void UpdateParticles(float dt) {
+    PROFILE_SCOPE("UpdateParticles");
+    particles.Update(dt);
+}
+
+// Every particle is a textured quad (the atlas' white disc) pushed straight
+// into rlgl's batch, so a whole pool ends up as a single draw call instead
+// of a circle fan each.
+void DrawParticlePool(const ParticlePool& pool) {
+    if (pool.count == 0) return;
+
+    Rectangle disc = SpriteRect(SPRITE_PARTICLE);
+    float u0 = disc.x / atlas.width, u1 = (disc.x + disc.width) / atlas.width;
+    float v0 = disc.y / atlas.height, v1 = (disc.y + disc.height) / atlas.height;
+
+    rlSetTexture(atlas.texture.id);
+    rlBegin(RL_QUADS);
+    rlNormal3f(0.0f, 0.0f, 1.0f);
 
-class Box {
-public:
-    Rectangle rect;
-    Box(float x, float y) {
-        rect = { x, y, TILE_SIZE, TILE_SIZE };
+    for (int i = 0; i < pool.count; i++) {
+        float t = (pool.maxLifetime[i] > 0.0f) ? (pool.lifetime[i] / pool.maxLifetime[i]) : 0.0f;
+        if (t < 0.0f) t = 0.0f;
+        if (t > 1.0f) t = 1.0f;
+        Color c = pool.color[i];
+        float r = pool.size[i] * (0.5f + 0.5f * t);
+        float x = pool.posX[i];
+        float y = pool.posY[i];
+
+        rlCheckRenderBatchLimit(4);
+        rlColor4ub(c.r, c.g, c.b, (unsigned char)(c.a * t));
+        rlTexCoord2f(u0, v0); rlVertex2f(x - r, y - r);
+        rlTexCoord2f(u0, v1); rlVertex2f(x - r, y + r);
+        rlTexCoord2f(u1, v1); rlVertex2f(x + r, y + r);
+        rlTexCoord2f(u1, v0); rlVertex2f(x + r, y - r);
     }
 
-    void Draw() {
-        Rectangle src = {0, 0, (float)boxTexture.width, (float)boxTexture.height};
-        Rectangle dst = GetRect();
-        if (dst.y < screenHeight / 2) src.height = -src.height;
-        DrawTexturePro(boxTexture, src, dst, {0, 0}, 0, boxTint);
+    rlEnd();
+    rlSetTexture(0);
+}
+
+void DrawParticles(const ParticleSystem& ps) {
+    PROFILE_SCOPE("DrawParticles");
+    DrawParticlePool(ps.normal);
+    BeginBlendMode(BLEND_ADDITIVE);
+    DrawParticlePool(ps.additive);
+    EndBlendMode();
+}
+
+// Pushes one triangle, flipped if needed so rlgl's back-face culling keeps it
+void PushTrailTriangle(Vector2 a, Color ca, Vector2 b, Color cb, Vector2 c, Color cc) {
+    float cross = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    if (cross > 0.0f) {
+        Vector2 tp = b; b = c; c = tp;
+        Color tc = cb; cb = cc; cc = tc;
     }
+    rlColor4ub(ca.r, ca.g, ca.b, ca.a); rlVertex2f(a.x, a.y);
+    rlColor4ub(cb.r, cb.g, cb.b, cb.a); rlVertex2f(b.x, b.y);
+    rlColor4ub(cc.r, cc.g, cc.b, cc.a); rlVertex2f(c.x, c.y);
+}
 
-    Rectangle GetRect() {
-        return rect;
+// The whole trail is one ribbon: each point becomes a left/right vertex pair
+// across the direction of travel, and neighbouring pairs are joined into
+// triangles. Oldest end is thin and half transparent, newest end is wide and
+// fully faded, same as the circles it replaced.
+void DrawTrail(const Trail& tr, Color base) {
+    PROFILE_SCOPE("DrawTrail");
+    int n = tr.Size();
+    if (n < 2) return;
+
+    Vector2 prevL = { 0 }, prevR = { 0 };
+    Color prevCol = base;
+
+    // Textured with the atlas' white square, so it doesn't switch textures
+    Rectangle white = SpriteRect(SPRITE_WHITE);
+    rlSetTexture(atlas.texture.id);
+    rlBegin(RL_TRIANGLES);
+    rlTexCoord2f((white.x + white.width / 2) / atlas.width, (white.y + white.height / 2) / atlas.height);
+    for (int i = 0; i < n; ++i) {
+        Vector2 p = tr.Get(i);
+        Vector2 before = tr.Get(std::max(i - 1, 0));
+        Vector2 after = tr.Get(std::min(i + 1, n - 1));
+
+        float dx = after.x - before.x;
+        float dy = after.y - before.y;
+        float len = sqrtf(dx * dx + dy * dy);
+        Vector2 normal = (len > 0.0001f) ? Vector2{ -dy / len, dx / len } : Vector2{ 0.0f, 1.0f };
+
+        float t = (float)i / (n - 1);
+        float halfWidth = 2.0f + 6.0f * t;
+        Color col = Fade(base, (1.0f - t) * 0.5f);
+
+        Vector2 left = { p.x + normal.x * halfWidth, p.y + normal.y * halfWidth };
+        Vector2 right = { p.x - normal.x * halfWidth, p.y - normal.y * halfWidth };
+
+        if (i > 0) {
+            rlCheckRenderBatchLimit(6);
+            PushTrailTriangle(prevL, prevCol, prevR, prevCol, left, col);
+            PushTrailTriangle(prevR, prevCol, right, col, left, col);
+        }
+
+        prevL = left;
+        prevR = right;
+        prevCol = col;
     }
-};
+    rlEnd();
+    rlSetTexture(0);
+}
 
-struct MapText {
-    std::string text;
-    Vector2 pos;
-    int fontSize;
-    Color color;
+// Text rasterised once into a render texture and then drawn as one quad
+// instead of a quad per glyph, with its size measured once up front.
+struct TextSprite {
+    RenderTexture2D target = { 0 };
+    int width = 0, height = 0;
 };
 
+TextSprite BakeText(const char* text, int fontSize, Color color) {
+    TextSprite sprite;
+    sprite.width = MeasureText(text, fontSize);
+    sprite.height = fontSize;
+    if (sprite.width <= 0) return sprite;
+
+    sprite.target = LoadRenderTexture(sprite.width, sprite.height);
+    BeginPremultipliedTexture(sprite.target);
+    DrawText(text, 0, 0, fontSize, color);
+    EndPremultipliedTexture();
+    return sprite;
+}
+
+void UnloadTextSprite(TextSprite& sprite) {
+    if (sprite.target.id != 0) UnloadRenderTexture(sprite.target);
+    sprite = TextSprite();
+}
 
-std::vector<Rectangle> groundTiles;
-std::vector<Spike> spikes;
-std::vector<Box> boxes;
-std::vector<Vector2> trailPositions;
-std::vector<MapText> mapTexts = {
-    {"Press SPACE or CLICK to jump", {400, 400}, 20, WHITE},
-    {"Hit a Spike?... Well", {1400, 500}, 20, RED},
-    {"Also Gravity is Flipped past About here", {2000, screenHeight/2}, 20, YELLOW},
-    {"Maybe Jumping isnt always for the Best", {5555, 300}, 20, RED},
-    {"FLIP TIMEEE!", {6300, screenHeight/2}, 20, YELLOW},
-    {"Seems Simple? Good luck!", {7000, 500}, 20, RED},
-    {"Hands Hurt Yet??", {9000, 400}, 20, WHITE},
-    {"Yea theese ARE pretty hard good luck!", {8500, 500}, 20, RED},
-    {"Timing is EVERYTHING", {11000, 200}, 20, RED},
-    {"FLIP..FLIP..FLIP..FLIPPP", {10000, 500}, 20, YELLOW},
-    {"AAAND UR DONE.. Good Job u WIN", {12000, 400}, 20, WHITE},
+// Call between BeginBlendMode(BLEND_ALPHA_PREMULTIPLY) and EndBlendMode()
+void DrawTextSprite(const TextSprite& sprite, float x, float y, float scale = 1.0f) {
+    if (sprite.target.id == 0) return;
+    Texture2D tex = sprite.target.texture;
+    Rectangle src = { 0, 0, (float)tex.width, -(float)tex.height };
+    Rectangle dst = { x, y, sprite.width * scale, sprite.height * scale };
+    DrawTexturePro(tex, src, dst, { 0, 0 }, 0.0f, WHITE);
+}
+
+// Same thing centered on x, with a blend mode of its own (menu screens)
+void DrawTextSpriteCentered(const TextSprite& sprite, float centerX, float y, float scale = 1.0f) {
+    BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+    DrawTextSprite(sprite, centerX - sprite.width * scale / 2, y, scale);
+    EndBlendMode();
+}
+
+// The menu screens' strings never change, bake them once at startup
+struct UiTexts {
+    TextSprite title, subtitle, practiceOn, practiceOff;
+    TextSprite gameOver, retry;
+    TextSprite victory, victory1, victory2;
 };
 
-Player p1(restartPosition.x, restartPosition.y);
+UiTexts ui;
+
+void BakeUiTexts() {
+    ui.title = BakeText("CALCULUS DASH", 80, RAYWHITE);
+    ui.subtitle = BakeText("Press ENTER / CLICK to Play", 30, GRAY);
+    ui.practiceOn = BakeText("[P] Practice mode: ON", 20, GREEN);
+    ui.practiceOff = BakeText("[P] Practice mode: OFF", 20, DARKGRAY);
+    ui.gameOver = BakeText("GAME OVER!", 80, RED);
+    ui.retry = BakeText("[R] Click To Retry", 30, GRAY);
+    ui.victory = BakeText("VICTORYYY!", 80, RED);
+    ui.victory1 = BakeText("You Finished the Level! Your reward is Flex Points +1000", 30, BLACK);
+    ui.victory2 = BakeText("(send me ss i want opinions)", 30, GRAY);
+}
+
+void UnloadUiTexts() {
+    TextSprite* all[] = { &ui.title, &ui.subtitle, &ui.practiceOn, &ui.practiceOff, &ui.gameOver,
+                          &ui.retry, &ui.victory, &ui.victory1, &ui.victory2 };
+    for (TextSprite* sprite : all) UnloadTextSprite(*sprite);
+}
 
-Camera2D camera = { 0 };
+// Map texts come from the level (levelTexts, sorted by x). Only the ones
+// overlapping the camera are looked at, found by binary search, and they get
+// baked on demand into a few recycled slots like the tile chunks.
+const int TEXT_CACHE_SLOTS = 8;
 
-void LoadLevelFromFile(const char* filename) {
-    level.clear();
-    FILE* file = fopen(filename, "r");
-    if (file == NULL) {
-        TraceLog(LOG_ERROR, "Could not open level file!");
-        return;
-    }
+struct TextSlot {
+    int text = -1; // index into levelTexts
+    unsigned int lastUsed = 0;
+    TextSprite sprite;
+};
+
+TextSlot textCache[TEXT_CACHE_SLOTS];
+unsigned int textCacheFrame = 0;
+std::vector<int> levelTextWidth; // measured once per level
+int maxLevelTextWidth = 0;
 
-    char buffer[1024];
-    while (fgets(buffer, sizeof(buffer), file)) {
-        buffer[strcspn(buffer, "\n")] = '\0';
-        level.push_back(std::string(buffer));
+void UnloadTextCache() {
+    for (auto& slot : textCache) {
+        UnloadTextSprite(slot.sprite);
+        slot.text = -1;
     }
+}
 
-    fclose(file);
+// Needs the window (font) up. Call after loading a level.
+void MeasureLevelTexts() {
+    UnloadTextCache();
 
-    levelRows = level.size();
-    levelCols = level.empty() ? 0 : level[0].size();
+    levelTextWidth.resize(levelTexts.size());
+    maxLevelTextWidth = 0;
+    for (size_t i = 0; i < levelTexts.size(); i++) {
+        levelTextWidth[i] = MeasureText(levelTexts[i].text.c_str(), levelTexts[i].fontSize);
+        maxLevelTextWidth = std::max(maxLevelTextWidth, levelTextWidth[i]);
+    }
+}
 
+// Range [first, last) of levelTexts that can overlap the view horizontally
+void GetVisibleTextRange(const Rectangle& view, int& first, int& last) {
+    auto byX = [](const LevelText& t, float x) { return t.pos.x < x; };
+    first = (int)(std::lower_bound(levelTexts.begin(), levelTexts.end(), view.x - maxLevelTextWidth, byX) - levelTexts.begin());
+    last = (int)(std::lower_bound(levelTexts.begin(), levelTexts.end(), view.x + view.width, byX) - levelTexts.begin());
 }
 
+bool LevelTextVisible(int i, const Rectangle& view) {
+    const LevelText& t = levelTexts[i];
+    return CheckCollisionRecs({ t.pos.x, t.pos.y, (float)levelTextWidth[i], (float)t.fontSize }, view);
+}
 
-void LoadLevel() {
-    for (int y = 0; y < levelRows; y++) {
-        for (int x = 0; x < levelCols; x++) {
-            char tile = level[y][x];
-            float worldX = x * TILE_SIZE;
-            float worldY = y * TILE_SIZE;
+TextSlot* FindBakedText(int text) {
+    for (auto& slot : textCache) {
+        if (slot.text == text) return &slot;
+    }
+    return nullptr;
+}
 
-            if (tile == '#') {
-                groundTiles.push_back({ worldX, worldY, TILE_SIZE, TILE_SIZE });
-            }
-            else if (tile == '^') {
-                spikes.push_back(Spike(worldX, worldY));
-            }
-            else if (tile == 'B') {
-                boxes.push_back(Box(worldX, worldY));
+// Texts BakeVisibleTexts found on screen this frame, for DrawMapTexts to
+// draw without testing them all again (in frameArena, gone after EndDrawing)
+int* visibleTexts = nullptr;
+int visibleTextCount = 0;
+
+// Like BakeVisibleChunks, has to run outside BeginMode2D
+void BakeVisibleTexts(const Camera2D& cam) {
+    PROFILE_SCOPE("BakeVisibleTexts");
+    Rectangle view = GetCameraView(cam);
+    int first, last;
+    GetVisibleTextRange(view, first, last);
+    textCacheFrame++;
+
+    visibleTexts = frameArena.AllocArray<int>(std::max(last - first, 0));
+    visibleTextCount = 0;
+    for (int i = first; i < last; i++) {
+        if (!LevelTextVisible(i, view)) continue;
+        visibleTexts[visibleTextCount++] = i;
+
+        TextSlot* slot = FindBakedText(i);
+        if (slot == nullptr) {
+            for (auto& candidate : textCache) {
+                if (candidate.lastUsed == textCacheFrame) continue;
+                if (slot == nullptr || candidate.lastUsed < slot->lastUsed) slot = &candidate;
             }
+            if (slot == nullptr) continue; // drawn directly
+            const LevelText& t = levelTexts[i];
+            UnloadTextSprite(slot->sprite);
+            slot->sprite = BakeText(t.text.c_str(), t.fontSize, t.color);
+            slot->text = i;
         }
+        slot->lastUsed = textCacheFrame;
     }
 }
 
-void UpdateParticles() {
-    for (int i = (int)particles.size() - 1; i >= 0; --i) {
-        particles[i].Update(GetFrameTime());
-        if (particles[i].IsDead()) {
-            particles.erase(particles.begin() + i);
-        }
+// Call inside BeginMode2D(cam), after BakeVisibleTexts(cam) in the same frame
+void DrawMapTexts() {
+    PROFILE_SCOPE("DrawMapTexts");
+    BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+    for (int v = 0; v < visibleTextCount; v++) {
+        TextSlot* slot = FindBakedText(visibleTexts[v]);
+        if (slot == nullptr) continue;
+        const LevelText& t = levelTexts[visibleTexts[v]];
+        DrawTextSprite(slot->sprite, (float)(int)t.pos.x, (float)(int)t.pos.y);
     }
+    EndBlendMode();
 
-    const size_t MAX_PARTICLES = 400;
-    if (particles.size() > MAX_PARTICLES) {
-        particles.erase(particles.begin(), particles.begin() + (particles.size() - MAX_PARTICLES));
+    for (int v = 0; v < visibleTextCount; v++) {
+        if (FindBakedText(visibleTexts[v]) != nullptr) continue;
+        const LevelText& t = levelTexts[visibleTexts[v]];
+        DrawText(t.text.c_str(), (int)t.pos.x, (int)t.pos.y, t.fontSize, t.color);
     }
 }
 
-void DrawMapTexts() {
-    for (auto& mt : mapTexts) {
-        DrawText(mt.text.c_str(), (int)mt.pos.x, (int)mt.pos.y, mt.fontSize, mt.color);
-    }
+
+void DrawWorld(float playerX){
+    PROFILE_SCOPE("DrawWorld");
+    DrawBackground(playerX);
 }
 
+// level.bin when tools/levelconv has been run since level.txt was last
+// edited, otherwise the text so edits show up straight away
+const char* PickLevelFile() {
+    if (!FileExists("level.bin")) return "level.txt";
+    if (FileExists("level.txt") && GetFileModTime("level.txt") > GetFileModTime("level.bin")) return "level.txt";
+    return "level.bin";
+}
 
-void DrawWorld(){
-    float scrollX = fmodf(p1.pos.x * 0.8f, backgroundTexture.width);
-    if (scrollX < 0) scrollX += backgroundTexture.width; 
+const char* levelPath = "level.txt";
 
-    for (int x = -scrollX; x < screenWidth; x += backgroundTexture.width) {
-        for (int y = 0; y < screenHeight; y += backgroundTexture.height) {
-            DrawTexture(backgroundTexture, x, y, WHITE);
-        }
-    }
+// Room for a long run up front, so recording doesn't allocate mid-run
+const int RECORD_RESERVE_JUMPS = 4096;
+
+void ResetGame() {
+    run = RunState();
+    recording = Replay();
+    recording.levelFile = levelPath;
+    if (recordPath != nullptr) recording.jumpTicks.reserve(RECORD_RESERVE_JUMPS);
+    recordingValid = true;
 
-    DrawRectangleGradientV(
-        0, 0,
-        screenWidth, screenHeight,
-        Fade(bgUpTint, 0.3f),   
-        Fade(bgDownTint, 0.3)  
-    );    
+    particles.Clear();
+    checkpoints.clear();
+    ticksSinceCheckpoint = 0;
+
+    // The level itself never changes, only the streamed window goes back to the start
+    tileGrid.Scroll(p1.pos.x);
+
+    gameState = START;
 }
 
-void ResetGame() {
-    p1.pos = restartPosition;
-    p1.velocityY = 0;
-    p1.isGrounded = false;
-    p1.rotation = 0.0f;
-    p1.targetRotation = 0.0f;
-    p1.rotating = false;
-
-    groundTiles.clear();
-    spikes.clear();
-    boxes.clear();
-    particles.clear();
-    trailPositions.clear();
-
-    LoadLevelFromFile("level.txt");
+void PlaceCheckpoint() {
+    if (sim.outcome != SIM_RUNNING) return;
+    if ((int)checkpoints.size() >= MAX_CHECKPOINTS) checkpoints.erase(checkpoints.begin());
+
+    RunState cp = run;
+    cp.shakeDuration = 0.0f;
+    cp.simAccumulator = 0.0f;
+    cp.jumpQueued = false;
+    checkpoints.push_back(cp);
+    ticksSinceCheckpoint = 0;
+}
+
+// Back to the last checkpoint (or the start) without leaving PLAYING
+void RespawnAtCheckpoint() {
+    run = checkpoints.empty() ? RunState() : checkpoints.back();
+    particles.Clear();
+    ticksSinceCheckpoint = 0;
+    recordingValid = false; // the replay would need the checkpoint too
+    // The respawn ends the sim job, the main thread scrolls before the next one
+    if (!simWorker.Running()) tileGrid.Scroll(p1.pos.x);
+    gameState = PLAYING;
+}
+
+// Startup loading, see loader.h. The start screen is up from the first
+// frame with a progress bar and only lets you play once this is done.
+Image atlasImage = { 0 };
+Image backgroundImage = { 0 };
+bool loaded = false;
+bool startQueued = false; // ENTER during loading starts as soon as it's done
+
+void LoadSpritesCpu() {
+    LoadAtlasImage("assets", atlasImage);
+}
+
+void LoadSpritesGpu() {
+    UploadAtlas(atlasImage);
+    // Shapes (checkpoints, overlays) draw from the atlas too instead of
+    // raylib's own white texture
+    Rectangle white = SpriteRect(SPRITE_WHITE);
+    if (atlas.texture.id != 0) SetShapesTexture(atlas.texture, { white.x + 1, white.y + 1, white.width - 2, white.height - 2 });
+}
+
+void LoadBackgroundCpu() {
+    backgroundImage = LoadImage("assets/background.png");
+}
+
+void LoadBackgroundGpu() {
+    if (backgroundImage.data == NULL) return;
+    InitBackground(LoadTextureFromImage(backgroundImage), bgUpTint, bgDownTint);
+    UnloadImage(backgroundImage);
+}
+
+void LoadLevelCpu() {
+    levelPath = PickLevelFile();
+    LoadLevelFromFile(levelPath);
     LoadLevel();
+}
 
-    gameState = START;
+void LoadLevelGpu() {
+    recording.levelFile = levelPath;
+    MeasureLevelTexts(); // needs the font
 }
 
+// Files are what the web build fetches (see build_web.sh), desktop reads
+// whatever is on disk
+const LoadJob loadJobs[] = {
+    { "sprites", { "assets/atlas.png", "assets/atlas.txt" }, LoadSpritesCpu, LoadSpritesGpu },
+    { "background", { "assets/background.png" }, LoadBackgroundCpu, LoadBackgroundGpu },
+    { "level", { "level.bin" }, LoadLevelCpu, LoadLevelGpu },
+};
+
 void DrawStartScreen() {
     ClearBackground((Color){20, 20, 30, 255});
-    
-    const char* title = "CALCULUS DASH";
-    int fontSize = 80;
-    int titleWidth = MeasureText(title, fontSize);
-    DrawText(title, screenWidth/2 - titleWidth/2, screenHeight/4, fontSize, RAYWHITE);
 
-    const char* subtitle = "Press ENTER / CLICK to Play";
-    int subSize = 30;
-    int subWidth = MeasureText(subtitle, subSize);
-    DrawText(subtitle, screenWidth/2 - subWidth/2, screenHeight/2, subSize, GRAY);
+    DrawTextSpriteCentered(ui.title, screenWidth/2, screenHeight/4);
+    DrawTextSpriteCentered(practiceMode ? ui.practiceOn : ui.practiceOff, screenWidth/2, screenHeight/2 + 60);
+
+    if (loaded) {
+        DrawTextSpriteCentered(ui.subtitle, screenWidth/2, screenHeight/2);
+        return;
+    }
+
+    int barWidth = 400;
+    int x = screenWidth/2 - barWidth/2, y = screenHeight/2 + 10;
+    DrawRectangle(x, y, barWidth, 8, Fade(GRAY, 0.3f));
+    DrawRectangle(x, y, (int)(barWidth * LoadingProgress()), 8, RAYWHITE);
+    const char* status = LoadingStatus();
+    DrawText(status, screenWidth/2 - MeasureText(status, 20)/2, y - 30, 20, GRAY);
 }
 
 void UpdateStartScreen() {
-    if (IsKeyPressed(KEY_ENTER) || IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+    if (!loaded) loaded = UpdateLoading();
+    if (IsKeyPressed(KEY_P)) practiceMode = !practiceMode;
+    if (IsKeyPressed(KEY_ENTER) || IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) startQueued = true;
+    if (loaded && startQueued) {
+        startQueued = false;
         gameState = PLAYING;
     }
 }
 
 void DrawGameOverScreen() {
-        if (gameOverTimer < gameOverDelay) {
+        if (run.gameOverTimer < gameOverDelay) {
+        BakeVisibleChunks(camera);
+        BeginBloomScene();
         BeginMode2D(camera);
 
-        for (auto& g : groundTiles) {
-            float centerY = g.y + g.height / 2;
-            Color tint = (centerY < GetScreenHeight() / 2) ? floorDownTint : floorUpTint;
-            DrawTexturePro(floorTexture, {0,0,(float)floorTexture.width,(float)floorTexture.height}, g, {0,0}, 0.0f, tint);
-        }
-        for (auto& b : boxes)  b.Draw();
-        for (auto& s : spikes) s.Draw();
+        DrawLevelTiles(camera);
 
-        for (const auto& particle : particles) if (!particle.additive) particle.Draw();
-        BeginBlendMode(BLEND_ADDITIVE);
-        for (const auto& particle : particles) if (particle.additive) particle.Draw();
-        EndBlendMode();
+        DrawParticles(particles);
 
         float flash = sinf(GetTime() * 20);
-        if (flash > 0) p1.Draw();
+        if (flash > 0) DrawPlayer(p1);
 
         EndMode2D();
+        EndBloomScene();
 
     } 
     else{
@@ -435,27 +856,10 @@ void DrawGameOverScreen() {
             (Color){10, 0, 0, 255});
 
         // --- Pulsing GAME OVER text ---
-        const char* title = "GAME OVER!";
-        int fontSize = 80;
-
         float scale = 1.0f + 0.05f * sinf(GetTime() * 3.0f);
-        int baseWidth = MeasureText(title, fontSize);
-        int scaledWidth = (int)(baseWidth * scale);
-
-        DrawText(title,
-            screenWidth/2 - scaledWidth/2,
-            screenHeight/3,
-            (int)(fontSize * scale),
-            RED);
-
-        const char* retryText = "[R] Click To Retry";
-
-        int retryWidth = MeasureText(retryText, 30);
+        DrawTextSpriteCentered(ui.gameOver, screenWidth/2, screenHeight/3, scale);
 
-        DrawText(retryText,
-            screenWidth/2 - retryWidth/2,
-            screenHeight/2 + 100,
-            30, GRAY);
+        DrawTextSpriteCentered(ui.retry, screenWidth/2, screenHeight/2 + 100);
         }
     }
 
@@ -465,285 +869,450 @@ void DrawVictoryScreen(){
         (Color){255, 255, 255, 255});
 
     // --- Pulsing Victory text ---
-    const char* title = "VICTORYYY!";
-    int fontSize = 80;
-
     float scale = 1.0f + 0.05f * sinf(GetTime() * 3.0f);
-    int baseWidth = MeasureText(title, fontSize);
-    int scaledWidth = (int)(baseWidth * scale);
+    DrawTextSpriteCentered(ui.victory, screenWidth/2, screenHeight/3, scale);
+
+    DrawTextSpriteCentered(ui.victory1, screenWidth/2, screenHeight/2 + 100);
+    DrawTextSpriteCentered(ui.victory2, screenWidth/2, screenHeight/2 + 200);
+}
 
-    DrawText(title,
-        screenWidth/2 - scaledWidth/2,
-        screenHeight/3,
-        (int)(fontSize * scale),
-        RED);
-    const char* victory1Text = "You Finished the Level! Your reward is Flex Points +1000";
+void UpdateGameOverScreen() {
+    run.gameOverTimer += GetFrameTime();
+
+    if(run.gameOverTimer < gameOverDelay) {
+        run.gameOverTimer += GetFrameTime();
+        return;
+    }
+
+    if (IsKeyPressed(KEY_R)|| IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        ResetGame();
+        gameState = PLAYING;
+    }
+}
 
-    int victory1Width = MeasureText(victory1Text, 30);
 
-    DrawText(victory1Text,
-        screenWidth/2 - victory1Width/2,
-        screenHeight/2 + 100,
-        30, BLACK);    
 
-    const char* victory2Text = "(send me ss i want opinions)";
+// Dust along the foot contact line plus a few sparks when the player lands
+void SpawnLandingParticles(Vector2 foot, int gravityDirection) {
+    int dust = QualityCount(16), sparks = QualityCount(6);
+    for (int i = 0; i < dust; ++i) {
+        float baseDeg   = (gravityDirection == 1) ? 90.0f : -90.0f;
+        float spreadDeg = (float)GetRandomValue(-100, 100);
+        float ang       = (baseDeg + spreadDeg) * DEG2RAD;
+        float speed     = 120.0f + (float)GetRandomValue(0, 80);
+        Vector2 vel     = { cosf(ang) * speed, sinf(ang) * speed };
 
-    int victory2Width = MeasureText(victory2Text, 30);
+        float sz   = 4.0f + (float)GetRandomValue(0, 10) * 0.1f;
+        float life = 0.3f + (float)GetRandomValue(0, 10) * 0.01f;
+        particles.Spawn(foot, vel, sz, life, dustLandTint, false);
+    }
 
-    DrawText(victory2Text,
-        screenWidth/2 - victory2Width/2,
-        screenHeight/2 + 200,
-        30, GRAY);   
+    Color sparkTint = (gravityDirection == 1) ? sparkUpTint : sparkDownTint;
+    for (int i = 0; i < sparks; ++i) {
+        float baseDeg   = (gravityDirection == 1) ? -90.0f : 90.0f;
+        float spreadDeg = (float)GetRandomValue(-50, 50);
+        float ang       = (baseDeg + spreadDeg) * DEG2RAD;
+        float speed     = 200.0f + (float)GetRandomValue(0, 140);
+        Vector2 vel     = { cosf(ang) * speed, sinf(ang) * speed };
+
+        float sz   = 4.0f + (float)GetRandomValue(0, 8) * 0.1f;
+        float life = 0.10f + (float)GetRandomValue(0, 8) * 0.01f;
+        particles.Spawn(foot, vel, sz, life, sparkTint, true);
+    }
 }
 
-void UpdateGameOverScreen() {
-    gameOverTimer += GetFrameTime();
+// One fixed tick of the PLAYING state
+void StepPlaying() {
+    PROFILE_SCOPE("StepPlaying");
+    bool jump = run.jumpQueued;
+    run.jumpQueued = false;
+    if (jump && recordPath != nullptr) recording.jumpTicks.push_back(sim.tick);
+
+    // Keep the streamed columns around the player before the sim reads them.
+    // With the worker on, the window is scrolled once per frame before the
+    // job starts instead, one frame never moves more than a couple of columns.
+    if (!simWorker.Running()) tileGrid.Scroll(p1.pos.x);
+    SimEvents events = StepSimulation(sim, tileGrid, jump);
+
+    if (events.jumped) SpawnJumpParticles(events.jumpFoot, events.jumpGravity);
+    if (events.landed) {
+        run.shakeDuration = 0.2f;
+        SpawnLandingParticles(events.landFoot, events.landGravity);
+    }
+
+    trail.Push({ p1.pos.x + p1.width/2, (p1.gravityDirection == 1) ? p1.pos.y + p1.height - 8 : p1.pos.y + 8});
+
+    if (practiceMode && p1.isGrounded && sim.outcome == SIM_RUNNING &&
+        ++ticksSinceCheckpoint >= (int)(CHECKPOINT_INTERVAL / SIM_DT)) {
+        PlaceCheckpoint();
+    }
 
-    if(gameOverTimer < gameOverDelay) {
-        gameOverTimer += GetFrameTime();
+    if (sim.outcome == SIM_VICTORY) gameState = VICTORY;
+    if (sim.outcome == SIM_DEAD && practiceMode) {
+        RespawnAtCheckpoint();
         return;
     }
+    if (sim.outcome == SIM_DEAD) {
+        gameState = GAMEOVER;
+        run.gameOverTimer = 0.0f;
+    }
 
-    if (IsKeyPressed(KEY_R)|| IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-        ResetGame();
-        gameState = PLAYING;
+    if (sim.outcome != SIM_RUNNING && recordPath != nullptr && recordingValid) {
+        recording.outcome = sim.outcome;
+        recording.endTick = sim.tick;
+        recording.deathX = sim.deathX;
+        recording.deathY = sim.deathY;
+        SaveReplay(recordPath, recording);
+    }
+}
+
+// Screen shake for the frame, picked on the sim side so the draw stays read-only
+void UpdateShake(float dt) {
+    if (run.shakeDuration > 0) {
+        run.shakeOffset.x = (float)(GetRandomValue(-100, 100)) / 100.0f * shakeMagnitude;
+        run.shakeOffset.y = (float)(GetRandomValue(-100, 100)) / 100.0f * shakeMagnitude;
+        run.shakeDuration -= dt;
+    } else {
+        run.shakeOffset = { 0, 0 };
     }
 }
 
+// Input has to be read on the main thread, the sim job gets a copy
+FrameInput ReadFrameInput() {
+    FrameInput in;
+    in.dt = GetFrameTime();
+    in.jump = IsKeyPressed(KEY_SPACE) || IsMouseButtonPressed(MOUSE_LEFT_BUTTON);
+    in.placeCheckpoint = practiceMode && IsKeyPressed(KEY_Z);
+    in.removeCheckpoint = practiceMode && IsKeyPressed(KEY_X);
+    in.cheatFlip = IsKeyPressed(KEY_O);
+    in.cheatForward = IsKeyPressed(KEY_P);
+    return in;
+}
 
+// Simulation half of a PLAYING frame. Touches run state, particles and
+// checkpoints, never raylib's window or input.
+void SimulateFrame(const FrameInput& in) {
+    PROFILE_SCOPE("SimulateFrame");
+    if (in.jump) run.jumpQueued = true;
+
+    //DEVELOPMENT CHEATS MAKE SURE TO DELETE LATER U CHILD DONT U DARE FORGET MIDHUN
+    if (in.cheatFlip) { (p1.gravityDirection == 1) ? p1.pos.y -= 300 : p1.pos.y += 300; recordingValid = false; } // debug gravity flip
+    if (in.cheatForward) { p1.pos.x += 600; recordingValid = false; } // debug forward
+
+    if (in.placeCheckpoint) PlaceCheckpoint();
+    if (in.removeCheckpoint && !checkpoints.empty()) checkpoints.pop_back();
+
+    // Simulate in fixed SIM_DT ticks however long the frame took
+    run.simAccumulator += std::min(in.dt, MAX_FRAME_TIME);
+    // (a practice respawn inside StepPlaying zeroes the accumulator)
+    while (run.simAccumulator >= SIM_DT && gameState == PLAYING) {
+        run.simAccumulator -= SIM_DT;
+        StepPlaying();
+    }
 
-int main() {
-    InitWindow(screenWidth, screenHeight, "Geometry Dash v2");
-    SetTargetFPS(60);
-    
-    floorTexture = LoadTexture("assets/floor.png");
-    playerTexture = LoadTexture("assets/player.png");
-    boxTexture = LoadTexture("assets/box.png");
-    spikeTexture = LoadTexture("assets/spike.png");
-    backgroundTexture = LoadTexture("assets/background.png");
+    UpdateParticles(in.dt);
+    UpdateShake(in.dt);
+}
 
-    LoadLevelFromFile("level.txt");
-    LoadLevel();
+void BuildSnapshot(RenderSnapshot& s) {
+    PROFILE_SCOPE("BuildSnapshot");
+    s.alpha = run.simAccumulator / SIM_DT;
+    s.player = p1;
+    camera.target.x = p1.RenderPos(s.alpha).x + screenWidth/4;
+    s.camera = camera;
+    s.shakeOffset = run.shakeOffset;
+    s.trail = trail;
+    s.trail.length = std::min(trail.length, Quality().trailLength);
+    s.particles.CopyFrom(particles);
+
+    s.checkpointCount = 0;
+    for (const RunState& cp : checkpoints) {
+        const Player& p = cp.sim.player;
+        s.checkpoints[s.checkpointCount++] = { p.pos.x + p.width/2, p.pos.y + p.height/2 };
+    }
+}
 
-    camera.target = {p1.pos.x + screenWidth/4, screenHeight/2.0f};
-    camera.offset = {screenWidth/2.0f, screenHeight/2.0f};
-    camera.rotation = 0.0f;
-    camera.zoom = 1.0f;
+// Runs on simWorker, between Kick() and Wait()
+void SimJob() {
+    SimulateFrame(simInput);
+    BuildSnapshot(snapshots[simBack]);
+}
 
-    while (!WindowShouldClose()) {
-        BeginDrawing();
-        ClearBackground(BLACK);
+void DrawCheckpoints(const RenderSnapshot& s) {
+    for (int i = 0; i < s.checkpointCount; i++) {
+        DrawPoly(s.checkpoints[i], 4, 12.0f, 0.0f, Fade(GREEN, 0.6f));
+    }
+}
 
-        if(gameState == START){
-            DrawStartScreen();
-            UpdateStartScreen();
-        }
+// Draws the PLAYING state with the player blended `alpha` of the way into the
+// current tick, so motion stays smooth whatever the display refresh rate is.
+void DrawPlaying(const RenderSnapshot& s) {
+    PROFILE_SCOPE("DrawPlaying");
+    Vector2 renderPos = s.player.RenderPos(s.alpha);
 
-        else if(gameState == PLAYING){
-            if(IsKeyPressed(KEY_SPACE) || IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) p1.Jump();
-            
-            //DEVELOPMENT CHEATS MAKE SURE TO DELETE LATER U CHILD DONT U DARE FORGET MIDHUN
-            if(IsKeyPressed(KEY_O)) (p1.gravityDirection == 1) ? p1.pos.y -= 300 : p1.pos.y += 300; // debug gravity flip
-            if(IsKeyPressed(KEY_P)) p1.pos.x += 600; // debug forward
+    Camera2D shakenCamera = s.camera;
+    shakenCamera.target.x += s.shakeOffset.x;
+    shakenCamera.target.y += s.shakeOffset.y;
 
-            if (p1.pos.x > 12500) gameState = VICTORY;
-            
-            DrawWorld();
-            
-            p1.Update();
-            p1.isGrounded = false;
+    // Baking uses texture mode, it can't go inside the bloom scene
+    BakeVisibleChunks(shakenCamera);
+    BakeVisibleTexts(shakenCamera);
 
-            float prevX = p1.pos.x;
-            float prevY = p1.pos.y;
+    BeginBloomScene();
+    DrawWorld(renderPos.x);
+    BeginMode2D(shakenCamera);
 
-            p1.pos.x += scrollSpeed;
-            p1.velocityX = scrollSpeed; 
+    DrawTrail(s.trail, (s.player.gravityDirection == 1) ? trailTintUp : trailTintDown);
 
-            camera.target.x = p1.pos.x + screenWidth/4;
+    DrawMapTexts();
 
-            UpdateParticles();
+    DrawLevelTiles(shakenCamera);
 
-            trailPositions.push_back({ p1.pos.x + p1.width/2, (p1.gravityDirection == 1) ? p1.pos.y + p1.height - 8 : p1.pos.y + 8});
+    DrawParticles(s.particles);
 
-            if (trailPositions.size() > 20) {
-                trailPositions.erase(trailPositions.begin());
-            }
+    if (practiceMode) DrawCheckpoints(s);
 
-            std::vector<Rectangle> allRects = groundTiles;
-            for (auto& b : boxes) allRects.push_back(b.GetRect());
-
-            for (auto& s : spikes) {
-                float spikePadding = 8.0f; 
-                Rectangle spikeRect = s.GetRect();
-                spikeRect.x += spikePadding;
-                spikeRect.y += spikePadding;
-                spikeRect.width -= spikePadding * 2;
-                spikeRect.height -= spikePadding * 2;
-
-                if (CheckCollisionRecs(p1.GetRect(), spikeRect)) {
-                    gameState = GAMEOVER;
-                    gameOverTimer = 0.0f;
-                }
-            }
+    DrawPlayer(s.player, s.alpha);
+    
+    EndMode2D();
+    EndBloomScene();
 
-            for (auto& rect : allRects) {
-                if (CheckCollisionRecs(p1.GetRect(), rect)) {
-
-                    float px = p1.pos.x;
-                    float py = p1.pos.y;
-                    float pw = p1.width;
-                    float ph = p1.height;
-
-                    // Amount overlapped in both directions
-                    float overlapX = std::min(px + pw, rect.x + rect.width) - std::max(px, rect.x);
-                    float overlapY = std::min(py + ph, rect.y + rect.height) - std::max(py, rect.y);
-
-                    // Vertical collision
-                    if (overlapY < overlapX) {
-                        // Hitting ground from above
-                        if (p1.gravityDirection == 1 && p1.velocityY > 0) {
-                            p1.pos.y = rect.y - ph;
-                            p1.velocityY = 0;
-                            p1.isGrounded = true;
-                        }
-                        // Hitting ceiling from below
-                        else if (p1.gravityDirection == 1 && p1.velocityY < 0) {
-                            p1.pos.y = rect.y + rect.height;
-                            p1.velocityY = 0;
-                        }
-                        // Hitting ceiling in inverted gravity
-                        else if (p1.gravityDirection == -1 && p1.velocityY < 0) {
-                            p1.pos.y = rect.y + rect.height;
-                            p1.velocityY = 0;
-                            p1.isGrounded = true;
-                        }
-                        // Hitting ground in inverted gravity
-                        else if (p1.gravityDirection == -1 && p1.velocityY > 0) {
-                            p1.pos.y = rect.y - ph;
-                            p1.velocityY = 0;
-                        }
-                    }
-                    // Horizontal collision
-                    else {
-                        if (p1.velocityX > 0 && prevX + pw <= rect.x) {
-                            p1.pos.x = rect.x - pw;
-                            p1.velocityX = 0;
-                        }
-                        else if (p1.velocityX < 0 && prevX >= rect.x + rect.width) {
-                            p1.pos.x = rect.x + rect.width;
-                            p1.velocityX = 0;
-                        }
-                    }
-                }
-            }
+    if (practiceMode) DrawText("PRACTICE  [Z] checkpoint  [X] remove last", 20, 20, 20, GREEN);
+}
 
-            // Check for landing (was in air, now grounded)
-            if (!wasGroundedLastFrame && p1.isGrounded) {
-                shakeDuration = 0.2f;
-
-                // Emit dust along the foot contact line
-                Vector2 foot = { p1.pos.x + p1.width * 0.5f, (p1.gravityDirection == 1) ? (p1.pos.y + p1.height) : p1.pos.y };
-
-                for (int i = 0; i < 16; ++i) {
-                    float baseDeg   = (p1.gravityDirection == 1) ? 90.0f : -90.0f;
-                    float spreadDeg = (float)GetRandomValue(-100, 100);
-                    float ang       = (baseDeg + spreadDeg) * DEG2RAD;
-                    float speed     = 120.0f + (float)GetRandomValue(0, 80);
-                    Vector2 vel     = { cosf(ang) * speed, sinf(ang) * speed };
-
-                    float sz   = 4.0f + (float)GetRandomValue(0, 10) * 0.1f;
-                    float life = 0.3f + (float)GetRandomValue(0, 10) * 0.01f;
-                    particles.push_back(Particle(foot, vel, sz, life, dustLandTint, false));
-                }
-
-                Color sparkTint = (p1.gravityDirection == 1) ? sparkUpTint : sparkDownTint;
-                for (int i = 0; i < 6; ++i) {
-                    float baseDeg   = (p1.gravityDirection == 1) ? -90.0f : 90.0f;
-                    float spreadDeg = (float)GetRandomValue(-50, 50);
-                    float ang       = (baseDeg + spreadDeg) * DEG2RAD;
-                    float speed     = 200.0f + (float)GetRandomValue(0, 140);
-                    Vector2 vel     = { cosf(ang) * speed, sinf(ang) * speed };
-
-                    float sz   = 4.0f + (float)GetRandomValue(0, 8) * 0.1f;
-                    float life = 0.10f + (float)GetRandomValue(0, 8) * 0.01f;
-                    particles.push_back(Particle(foot, vel, sz, life, sparkTint, true));
-                }
+// Pushes the current quality tier into everything it scales. Only while the
+// sim job isn't running, spawning reads the tier on the worker.
+void ApplyQuality() {
+    const QualitySettings& q = Quality();
+    particles.SetLimit(q.particleLimit);
+    SetBackgroundLayers(q.backgroundLayers);
+    SetBloomQuality(q.bloomDownscale, q.renderScale);
+}
 
-            }
+// F6: heap allocations per frame (should stay at 0 while playing) and how
+// much of the frame arena gets used. --strict-allocs logs every gameplay
+// frame that allocates.
+bool memoryOverlay = false;
+bool strictAllocs = false;
+
+void DrawMemoryOverlay() {
+    AllocFrameStats a = AllocGetStats();
+    int x = 10, line = 18, y = screenHeight - 5 * line - 10;
+    DrawRectangle(x - 5, y - 5, 330, 5 * line + 10, Fade(BLACK, 0.75f));
+    Color c = (a.count > 0) ? RED : RAYWHITE;
+    DrawText(TextFormat("allocs/frame %d (%lld B)", a.count, a.bytes), x, y, 16, c);
+    y += line;
+    DrawText(TextFormat("peak %d (%lld B) over %d frames", a.peakCount, a.peakBytes, a.frames), x, y, 16, RAYWHITE);
+    y += line;
+    DrawText(TextFormat("frames that allocated: %d", a.framesWithAllocs), x, y, 16, a.framesWithAllocs > 0 ? YELLOW : RAYWHITE);
+    y += line;
+    DrawText(TextFormat("arena %d / %d B, peak %d", (int)frameArena.used, (int)frameArena.capacity, (int)frameArena.peak), x, y, 16, RAYWHITE);
+    y += line;
+    DrawText(TextFormat("arena overflows %d", frameArena.overflows), x, y, 16, frameArena.overflows > 0 ? RED : GRAY);
+}
 
-            wasGroundedLastFrame = p1.isGrounded;
+// F3 toggles the profiler overlay, F4 starts/stops a Chrome trace capture
+// (--trace <file> captures from startup until exit), F5 toggles bloom so its
+// cost shows up in the overlay with and without
+const char* tracePath = "trace.json";
+
+void DrawProfilerOverlay() {
+    ProfileStats stats[PROFILE_MAX_ZONES];
+    int n = ProfilerGetStats(stats, PROFILE_MAX_ZONES);
+
+    // The default font isn't monospaced, so every column gets its own x
+    int x = screenWidth - 420, y = 10, line = 18;
+    const int cols[3] = { x + 170, x + 250, x + 330 };
+    DrawRectangle(x - 10, y - 5, 420, (n + 4) * line + 10, Fade(BLACK, 0.75f));
+
+    DrawText("ms", x, y, 16, YELLOW);
+    DrawText("min", cols[0], y, 16, YELLOW);
+    DrawText("avg", cols[1], y, 16, YELLOW);
+    DrawText("p99", cols[2], y, 16, YELLOW);
+    y += line;
+
+    for (int i = 0; i < n; i++) {
+        DrawText(stats[i].name, x, y, 16, RAYWHITE);
+        DrawText(TextFormat("%6.2f", stats[i].minMs), cols[0], y, 16, RAYWHITE);
+        DrawText(TextFormat("%6.2f", stats[i].avgMs), cols[1], y, 16, RAYWHITE);
+        DrawText(TextFormat("%6.2f", stats[i].p99Ms), cols[2], y, 16, RAYWHITE);
+        y += line;
+    }
 
-            if (shakeDuration > 0) {
-                shakeOffset.x = (float)(GetRandomValue(-100, 100)) / 100.0f * shakeMagnitude;
-                shakeOffset.y = (float)(GetRandomValue(-100, 100)) / 100.0f * shakeMagnitude;
-                shakeDuration -= GetFrameTime();
-            } else {
-                shakeOffset = { 0, 0 };
-            }
+    bool rec = ProfilerCapturing();
+    DrawText(TextFormat("%d fps   [F4] %s", GetFPS(), rec ? "capturing..." : "capture trace"), x, y, 16, rec ? RED : GRAY);
+    y += line;
+    DrawText(TextFormat("[F5] bloom %s", BloomActive() ? "on" : "off"), x, y, 16, GRAY);
+    y += line;
+    DrawText(TextFormat("quality %s%s   frame %.1f  work %.1f ms", QualityTierName(quality.tier), quality.automatic ? "" : " (fixed)",
+                        quality.avgFrame * 1000.0f, quality.avgWork * 1000.0f), x, y, 16, GRAY);
+}
 
-            Camera2D shakenCamera = camera;
-            shakenCamera.target.x += shakeOffset.x;
-            shakenCamera.target.y += shakeOffset.y;
-
-            BeginMode2D(shakenCamera);
-
-            float worldY = screenHeight/2.0f;
-            float worldLeft = camera.target.x - screenWidth;
-            float worldRight = camera.target.x + screenWidth;
-            
-            int N = (int)trailPositions.size();
-            for (int i = 0; i < N; ++i) {
-                float t = (N > 1) ? (float)i / (N - 1) : 1.0f; 
-                float radius = 2.0f + 6.0f * t; 
-                Color base = (p1.gravityDirection == 1) ? trailTintUp : trailTintDown;
-                Color col  = Fade(base, (1.0f - t) * 0.5f);
-                DrawCircleV(trailPositions[i], radius, col);
-            }
+float workTime = 0.0f; // last frame, up to EndDrawing
+int playingFrames = 0; // in a row, the first ones of a run may still warm up
+
+// One frame: sim (or picking up the worker's), drawing, overlays. Desktop
+// calls it in a loop, the browser calls it once per animation frame.
+void UpdateDrawFrame() {
+    double frameStart = GetTime();
+    // Last frame's sim job has to be done before anything reads game state
+    bool simDone = false;
+    if (simWorker.Running()) {
+        PROFILE_SCOPE("WaitSim");
+        simWorker.Wait();
+        simDone = simPending;
+        simPending = false;
+    }
 
-            DrawMapTexts();
+    // Read while the sim job is idle, it can change gameState once kicked
+    bool playing = gameState == PLAYING;
 
-            for (auto& g : groundTiles) {
-                float centerY = g.y + g.height / 2;
-                Color tint = (centerY < GetScreenHeight() / 2) ? floorDownTint : floorUpTint;
-                DrawTexturePro(floorTexture, { 0, 0, (float)floorTexture.width, (float)floorTexture.height }, g, { 0, 0 }, 0.0f, tint);
-            }
+    // Only gameplay frames count, menus are cheap and loading hitches
+    if (playing && UpdateQuality(GetFrameTime(), workTime)) {
+        TraceLog(LOG_INFO, "Quality: %s", QualityTierName(quality.tier));
+        ApplyQuality();
+    }
 
-            for (auto& b : boxes)  b.Draw();
-            for (auto& s : spikes) s.Draw();
+    BeginDrawing();
+    ClearBackground(BLACK);
 
-            for (const auto& particle : particles) {
-                if (!particle.additive) particle.Draw();
-            }
+    if(gameState == START){
+        DrawStartScreen();
+        UpdateStartScreen();
+    }
 
-            BeginBlendMode(BLEND_ADDITIVE);
-            for (const auto& particle : particles) {
-                if (particle.additive) particle.Draw();
-            }
-            EndBlendMode();
+    else if(gameState == PLAYING){
+        FrameInput in = ReadFrameInput();
 
-            p1.Draw();
-            
-            EndMode2D();
-        }
+        if (simWorker.Running()) {
+            // First frame of a run has nothing in flight yet, snapshot the start
+            if (!simDone) BuildSnapshot(snapshots[simBack]);
+            int front = simBack;
+            simBack ^= 1;
+
+            tileGrid.Scroll(p1.pos.x);
+            simInput = in;
+            simPending = true;
+            simWorker.Kick();
 
-        else if (gameState == GAMEOVER){
-            DrawGameOverScreen();
-            UpdateGameOverScreen();
+            DrawPlaying(snapshots[front]);
+        } else {
+            SimulateFrame(in);
+            BuildSnapshot(snapshots[0]);
+            DrawPlaying(snapshots[0]);
         }
-        else if (gameState == VICTORY){
-            DrawVictoryScreen();
-        }   
+    }
+
+    else if (gameState == GAMEOVER){
+        DrawGameOverScreen();
+        UpdateGameOverScreen();
+    }
+    else if (gameState == VICTORY){
+        DrawVictoryScreen();
+    }   
+
+    if (IsKeyPressed(KEY_F3)) ProfilerSetOverlay(!ProfilerOverlay());
+    if (IsKeyPressed(KEY_F5)) SetBloom(!bloom.enabled);
+    if (IsKeyPressed(KEY_F6)) memoryOverlay = !memoryOverlay;
+    if (IsKeyPressed(KEY_F4)) {
+        if (ProfilerCapturing()) ProfilerStopCapture();
+        else ProfilerStartCapture(tracePath);
+    }
+    if (ProfilerOverlay()) DrawProfilerOverlay();
+    if (memoryOverlay) DrawMemoryOverlay();
 
+    workTime = (float)(GetTime() - frameStart);
+    {
+        PROFILE_SCOPE("EndDrawing"); // includes waiting on vsync
         EndDrawing();
     }
+    ProfilerEndFrame();
+
+    // Everything from this frame's arena is dead now
+    frameArena.Reset();
+    int allocs = AllocEndFrame();
+    playingFrames = playing ? playingFrames + 1 : 0;
+    if (strictAllocs && allocs > 0 && playingFrames > 2) {
+        AllocFrameStats a = AllocGetStats();
+        TraceLog(LOG_WARNING, "Gameplay frame allocated %d times (%lld bytes)", a.count, a.bytes);
+    }
+}
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) recordPath = argv[++i];
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            tracePath = argv[++i];
+            ProfilerStartCapture(tracePath);
+        }
+        else if (strcmp(argv[i], "--no-threads") == 0) useSimWorker = false;
+        else if (strcmp(argv[i], "--no-bloom") == 0) SetBloom(false);
+        else if (strcmp(argv[i], "--strict-allocs") == 0) strictAllocs = true;
+        else if (strcmp(argv[i], "--quality") == 0 && i + 1 < argc) {
+            // Fixed tier, the governor stays out of it
+            const char* name = argv[++i];
+            for (int t = 0; t < QUALITY_TIER_COUNT; t++) {
+                if (strcmp(name, QualityTierName((QualityTier)t)) == 0) SetQualityTier((QualityTier)t, false);
+            }
+        }
+    }
+
+    // Render as fast as the display refreshes, the simulation has its own clock
+    SetConfigFlags(FLAG_VSYNC_HINT);
+    InitWindow(screenWidth, screenHeight, "Geometry Dash v2");
+    int refreshRate = GetMonitorRefreshRate(GetCurrentMonitor());
+    int targetFps = refreshRate > 0 ? refreshRate : 60;
+#if !defined(PLATFORM_WEB) && !defined(__EMSCRIPTEN__)
+    // (the browser paces frames itself, waiting in EndDrawing would block the page)
+    SetTargetFPS(targetFps);
+#endif
+    InitQuality(targetFps);
+    
+    // Only the menu texts are made up front, the rest loads while the start
+    // screen is already showing
+    BakeUiTexts();
+    InitBloom();
+    StartLoading(loadJobs, sizeof(loadJobs) / sizeof(loadJobs[0]), useSimWorker);
+
+    particles.Init(MAX_PARTICLES);
+    for (RenderSnapshot& s : snapshots) s.particles.Init(MAX_PARTICLES);
+    ApplyQuality();
+
+    checkpoints.reserve(MAX_CHECKPOINTS);
+    if (recordPath != nullptr) recording.jumpTicks.reserve(RECORD_RESERVE_JUMPS);
+    frameArena.Init(FRAME_ARENA_SIZE);
+    if (useSimWorker) {
+        simWorker.Start(SimJob);
+        // Whatever cores the main thread and the sim worker leave over, for
+        // big particle pools. Ours are too small to be split (see particles.h),
+        // so no threads sit idle unless MAX_PARTICLES goes up.
+        if (MAX_PARTICLES >= PARTICLE_PARALLEL_MIN) {
+            int cores = (int)std::thread::hardware_concurrency();
+            jobPool.Start(std::min(std::max(cores - 2, 0), 3));
+        }
+    }
+
+#if defined(PLATFORM_WEB) || defined(__EMSCRIPTEN__)
+    // The browser drives the frames, main() never returns
+    emscripten_set_main_loop(UpdateDrawFrame, 0, 1);
+#else
+    while (!WindowShouldClose()) UpdateDrawFrame();
+
+    simWorker.Stop();
+    jobPool.Stop();
+    StopLoading();
 
     //UNLOAD DA TAXTURES
-    UnloadTexture(playerTexture);
-    UnloadTexture(floorTexture);
-    UnloadTexture(backgroundTexture);
-    UnloadTexture(boxTexture);
-    UnloadTexture(spikeTexture);
+    UnloadAtlas();
+    UnloadBackground();
+    UnloadBloom();
+    UnloadChunkCache();
+    UnloadTextCache();
+    UnloadUiTexts();
+    frameArena.Shutdown();
+    ProfilerStopCapture();
 
     CloseWindow();
+#endif
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include "mapfile.h"
+
+#if defined(_WIN32)
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+
+bool MapFile(const char* path, MappedFile& file) {
+    UnmapFile(file);
+
+    HANDLE f = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (f == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(f, &size) || size.QuadPart == 0) {
+        CloseHandle(f);
+        return false;
+    }
+
+    // The mapping keeps the file alive, the file handle isn't needed after this
+    HANDLE mapping = CreateFileMappingA(f, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(f);
+    if (mapping == NULL) return false;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == NULL) {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    file.data = (const unsigned char*)view;
+    file.size = (size_t)size.QuadPart;
+    file.handle = mapping;
+    return true;
+}
+
+void UnmapFile(MappedFile& file) {
+    if (file.data != nullptr) UnmapViewOfFile(file.data);
+    if (file.handle != nullptr) CloseHandle((HANDLE)file.handle);
+    file = MappedFile();
+}
+
+#elif defined(__EMSCRIPTEN__)
+
+#include <cstdio>
+#include <cstdlib>
+
+// Preloaded files live in MEMFS, there is nothing to map
+bool MapFile(const char* path, MappedFile& file) {
+    UnmapFile(file);
+
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) return false;
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    unsigned char* buffer = (size > 0) ? (unsigned char*)malloc(size) : nullptr;
+    if (buffer == nullptr || fread(buffer, 1, size, f) != (size_t)size) {
+        free(buffer);
+        fclose(f);
+        return false;
+    }
+    fclose(f);
+
+    file.data = buffer;
+    file.size = (size_t)size;
+    file.handle = buffer;
+    return true;
+}
+
+void UnmapFile(MappedFile& file) {
+    free(file.handle);
+    file = MappedFile();
+}
+
+#else
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+bool MapFile(const char* path, MappedFile& file) {
+    UnmapFile(file);
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) return false;
+
+    file.data = (const unsigned char*)view;
+    file.size = (size_t)st.st_size;
+    return true;
+}
+
+void UnmapFile(MappedFile& file) {
+    if (file.data != nullptr) munmap((void*)file.data, file.size);
+    file = MappedFile();
+}
+
+#endif
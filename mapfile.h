@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+
+// Read-only view of a whole file. Memory-mapped on desktop so opening it
+// costs nothing up front and pages come in as they get touched. On web the
+// file already sits in memory (preload bundle), so it is just read in.
+// Kept away from raylib.h on purpose, windows.h and raylib don't mix.
+struct MappedFile {
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+    void* handle = nullptr; // mapping handle or owned buffer, per platform
+};
+
+bool MapFile(const char* path, MappedFile& file);
+void UnmapFile(MappedFile& file);
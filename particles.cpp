@@ -0,0 +1,148 @@
+#include "particles.h"
+#include "worker.h"
+#include <algorithm>
+#include <atomic>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PARTICLES_SSE
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
+void ParticlePool::Init(int cap) {
+    capacity = cap;
+    limit = cap;
+    posX.assign(cap, 0.0f);
+    posY.assign(cap, 0.0f);
+    velX.assign(cap, 0.0f);
+    velY.assign(cap, 0.0f);
+    size.assign(cap, 0.0f);
+    lifetime.assign(cap, 0.0f);
+    maxLifetime.assign(cap, 0.0f);
+    color.assign(cap, BLANK);
+    Clear();
+}
+
+// Integration kernel: moves particles [begin, end) by their velocity and
+// ages them, a SIMD register of particles at a time. Returns true if any of
+// them ran out of lifetime, so the removal pass can be skipped otherwise.
+// Plain mul + add per lane, same results as the scalar tail.
+static bool IntegrateRange(float* __restrict px, float* __restrict py, const float* __restrict vx,
+                           const float* __restrict vy, float* __restrict life, int begin, int end, float dt) {
+    int i = begin;
+    bool anyDead = false;
+
+#if defined(__AVX__)
+    __m256 vdt = _mm256_set1_ps(dt);
+    __m256 zero = _mm256_setzero_ps();
+    __m256 dead = zero;
+    for (; i + 8 <= end; i += 8) {
+        _mm256_storeu_ps(px + i, _mm256_add_ps(_mm256_loadu_ps(px + i), _mm256_mul_ps(_mm256_loadu_ps(vx + i), vdt)));
+        _mm256_storeu_ps(py + i, _mm256_add_ps(_mm256_loadu_ps(py + i), _mm256_mul_ps(_mm256_loadu_ps(vy + i), vdt)));
+        __m256 l = _mm256_sub_ps(_mm256_loadu_ps(life + i), vdt);
+        _mm256_storeu_ps(life + i, l);
+        dead = _mm256_or_ps(dead, _mm256_cmp_ps(l, zero, _CMP_LE_OQ));
+    }
+    anyDead = _mm256_movemask_ps(dead) != 0;
+#elif defined(PARTICLES_SSE)
+    __m128 vdt = _mm_set1_ps(dt);
+    __m128 zero = _mm_setzero_ps();
+    __m128 dead = zero;
+    for (; i + 4 <= end; i += 4) {
+        _mm_storeu_ps(px + i, _mm_add_ps(_mm_loadu_ps(px + i), _mm_mul_ps(_mm_loadu_ps(vx + i), vdt)));
+        _mm_storeu_ps(py + i, _mm_add_ps(_mm_loadu_ps(py + i), _mm_mul_ps(_mm_loadu_ps(vy + i), vdt)));
+        __m128 l = _mm_sub_ps(_mm_loadu_ps(life + i), vdt);
+        _mm_storeu_ps(life + i, l);
+        dead = _mm_or_ps(dead, _mm_cmple_ps(l, zero));
+    }
+    anyDead = _mm_movemask_ps(dead) != 0;
+#elif defined(__wasm_simd128__)
+    v128_t vdt = wasm_f32x4_splat(dt);
+    v128_t zero = wasm_f32x4_splat(0.0f);
+    v128_t dead = wasm_i32x4_splat(0);
+    for (; i + 4 <= end; i += 4) {
+        wasm_v128_store(px + i, wasm_f32x4_add(wasm_v128_load(px + i), wasm_f32x4_mul(wasm_v128_load(vx + i), vdt)));
+        wasm_v128_store(py + i, wasm_f32x4_add(wasm_v128_load(py + i), wasm_f32x4_mul(wasm_v128_load(vy + i), vdt)));
+        v128_t l = wasm_f32x4_sub(wasm_v128_load(life + i), vdt);
+        wasm_v128_store(life + i, l);
+        dead = wasm_v128_or(dead, wasm_f32x4_le(l, zero));
+    }
+    anyDead = wasm_v128_any_true(dead);
+#endif
+
+    for (; i < end; i++) {
+        px[i] += vx[i] * dt;
+        py[i] += vy[i] * dt;
+        life[i] -= dt;
+        anyDead |= life[i] <= 0.0f;
+    }
+    return anyDead;
+}
+
+struct IntegrateJob {
+    ParticlePool* pool;
+    float dt;
+    std::atomic<bool> anyDead;
+};
+
+static void IntegrateJobRange(void* ctx, int begin, int end) {
+    IntegrateJob& job = *(IntegrateJob*)ctx;
+    ParticlePool& p = *job.pool;
+    if (IntegrateRange(p.posX.data(), p.posY.data(), p.velX.data(), p.velY.data(), p.lifetime.data(), begin, end, job.dt)) {
+        job.anyDead.store(true, std::memory_order_relaxed);
+    }
+}
+
+void ParticlePool::Update(float dt) {
+    int n = count;
+    bool anyDead;
+
+    // Small pools (the usual case) stay on this thread, waking the job
+    // pool costs more than integrating a few thousand particles
+    if (n >= PARTICLE_PARALLEL_MIN && jobPool.Threads() > 0) {
+        IntegrateJob job;
+        job.pool = this;
+        job.dt = dt;
+        job.anyDead = false;
+        jobPool.Run(IntegrateJobRange, &job, n, PARTICLE_PARALLEL_MIN / 2);
+        anyDead = job.anyDead;
+    } else {
+        anyDead = IntegrateRange(posX.data(), posY.data(), velX.data(), velY.data(), lifetime.data(), 0, n, dt);
+    }
+    if (!anyDead) return;
+
+    // Backwards so whatever gets swapped in has already been checked
+    for (int i = n - 1; i >= 0; --i) {
+        if (lifetime[i] <= 0.0f) Remove(i);
+    }
+}
+
+void ParticlePool::Remove(int i) {
+    int last = --count;
+    if (i == last) return;
+    posX[i] = posX[last];
+    posY[i] = posY[last];
+    velX[i] = velX[last];
+    velY[i] = velY[last];
+    size[i] = size[last];
+    lifetime[i] = lifetime[last];
+    maxLifetime[i] = maxLifetime[last];
+    color[i] = color[last];
+}
+
+void ParticlePool::CopyFrom(const ParticlePool& other) {
+    limit = other.limit;
+    count = other.count;
+    evictCursor = other.evictCursor;
+    std::copy(other.posX.begin(), other.posX.begin() + count, posX.begin());
+    std::copy(other.posY.begin(), other.posY.begin() + count, posY.begin());
+    std::copy(other.velX.begin(), other.velX.begin() + count, velX.begin());
+    std::copy(other.velY.begin(), other.velY.begin() + count, velY.begin());
+    std::copy(other.size.begin(), other.size.begin() + count, size.begin());
+    std::copy(other.lifetime.begin(), other.lifetime.begin() + count, lifetime.begin());
+    std::copy(other.maxLifetime.begin(), other.maxLifetime.begin() + count, maxLifetime.begin());
+    std::copy(other.color.begin(), other.color.begin() + count, color.begin());
+}
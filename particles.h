@@ -0,0 +1,114 @@
+#pragma once
+
+#include "raylib.h"
+#include <vector>
+
+// Particles live in a fixed-capacity pool with one array per field, so the
+// update is a flat loop over floats the compiler can vectorize. Everything is
+// allocated once in Init(); spawning and removing never touch the heap.
+// Dead particles are swap-removed (last one moves into the hole). When the
+// pool is full, new particles overwrite slots in round-robin order, so a
+// burst replaces live sparks instead of being dropped. That isn't oldest
+// first: swap-removal shuffles particles between slots, so the cursor hits
+// whatever particle sits in the slot it lands on.
+// `limit` caps the live count below capacity without reallocating (the
+// quality governor lowers it on slow machines).
+const int MAX_PARTICLES = 4096; // per pool
+
+// Update() integrates with SSE/AVX (desktop) or WASM SIMD when the build
+// enables them. Pools at least this big get split across jobPool; below it
+// waking the threads costs more than it saves (see tools/bench). The game's
+// pools are MAX_PARTICLES, well under it, so only bigger pools (bench, or
+// MAX_PARTICLES raised) ever take that path.
+const int PARTICLE_PARALLEL_MIN = 32768;
+
+struct ParticlePool {
+    int capacity = 0;
+    int limit = 0; // <= capacity
+    int count = 0;
+    int evictCursor = 0;
+
+    std::vector<float> posX, posY;
+    std::vector<float> velX, velY;
+    std::vector<float> size;
+    std::vector<float> lifetime;     // remaining
+    std::vector<float> maxLifetime;  // initial
+    std::vector<Color> color;
+
+    void Init(int cap);
+
+    void Clear() {
+        count = 0;
+        evictCursor = 0;
+    }
+
+    // Drops the newest particles past the new limit
+    void SetLimit(int n) {
+        limit = n < capacity ? n : capacity;
+        if (count > limit) count = limit;
+        if (evictCursor >= limit) evictCursor = 0;
+    }
+
+    void Spawn(Vector2 pos, Vector2 vel, float s, float life, Color col) {
+        if (limit == 0) return;
+
+        int i;
+        if (count < limit) {
+            i = count++;
+        } else {
+            i = evictCursor; // round-robin overwrite, not necessarily the oldest
+            evictCursor = (evictCursor + 1) % limit;
+        }
+
+        posX[i] = pos.x;
+        posY[i] = pos.y;
+        velX[i] = vel.x;
+        velY[i] = vel.y;
+        size[i] = s;
+        lifetime[i] = life;
+        maxLifetime[i] = life;
+        color[i] = col;
+    }
+
+    void Update(float dt);
+    void Remove(int i);
+
+    // Copies only the live particles, capacity has to match
+    void CopyFrom(const ParticlePool& other);
+};
+
+// Normal and additive particles go into separate pools, so each blend mode
+// draws its pool in one go without filtering the other kind out first.
+struct ParticleSystem {
+    ParticlePool normal;
+    ParticlePool additive;
+
+    void Init(int cap) {
+        normal.Init(cap);
+        additive.Init(cap);
+    }
+
+    void Clear() {
+        normal.Clear();
+        additive.Clear();
+    }
+
+    void SetLimit(int n) {
+        normal.SetLimit(n);
+        additive.SetLimit(n);
+    }
+
+    void Spawn(Vector2 pos, Vector2 vel, float s, float life, Color col, bool add = false) {
+        (add ? additive : normal).Spawn(pos, vel, s, life, col);
+    }
+
+    void Update(float dt) {
+        normal.Update(dt);
+        additive.Update(dt);
+    }
+
+    void CopyFrom(const ParticleSystem& other) {
+        normal.CopyFrom(other.normal);
+        additive.CopyFrom(other.additive);
+    }
+};
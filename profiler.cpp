@@ -0,0 +1,198 @@
+#include "profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> profilerActive(false);
+
+struct ProfileZoneData {
+    const char* name = nullptr;
+    double frameUs = 0.0;             // summed over the current frame
+    float history[PROFILE_HISTORY];   // ms per frame, ring
+};
+
+struct TraceEvent {
+    int zone;
+    int thread;
+    double start, duration; // us
+};
+
+static ProfileZoneData zones[PROFILE_MAX_ZONES];
+static int zoneCount = 0;
+static std::mutex zoneMutex; // zones can first show up on the solver's threads
+
+// The game's sim worker records while the main thread draws. Only taken
+// while the profiler is on, a scope costs a flag check otherwise.
+static std::mutex recordMutex;
+static std::atomic<int> threadCount(0);
+static thread_local int threadId = ++threadCount; // trace lane, 1 = first thread that records
+
+static int historyHead = 0;   // next frame slot
+static int historyFrames = 0; // valid frames in the ring
+static double frameStart = -1.0;
+static int frameZone = -1;
+
+static bool overlayOn = false;
+static bool capturing = false;
+static std::vector<TraceEvent> events;
+static char capturePath[256];
+
+static void UpdateActive() {
+    profilerActive = overlayOn || capturing;
+}
+
+int ProfilerZone(const char* name) {
+    std::lock_guard<std::mutex> lock(zoneMutex);
+    for (int i = 0; i < zoneCount; i++) {
+        if (strcmp(zones[i].name, name) == 0) return i;
+    }
+    if (zoneCount == PROFILE_MAX_ZONES) return PROFILE_MAX_ZONES - 1; // lumped together, raise the limit
+    zones[zoneCount].name = name;
+    std::fill(zones[zoneCount].history, zones[zoneCount].history + PROFILE_HISTORY, 0.0f);
+    return zoneCount++;
+}
+
+double ProfilerNow() {
+    using namespace std::chrono;
+    return duration<double, std::micro>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Returns true when the capture buffer just filled up. Caller holds recordMutex.
+static bool RecordLocked(int zone, double startUs, double endUs) {
+    zones[zone].frameUs += endUs - startUs;
+
+    if (capturing) {
+        events.push_back({ zone, threadId, startUs, endUs - startUs });
+        return (int)events.size() >= PROFILE_MAX_EVENTS;
+    }
+    return false;
+}
+
+void ProfilerRecord(int zone, double startUs, double endUs) {
+    bool full;
+    {
+        std::lock_guard<std::mutex> lock(recordMutex);
+        full = RecordLocked(zone, startUs, endUs);
+    }
+    if (full) ProfilerStopCapture();
+}
+
+void ProfilerEndFrame() {
+    if (frameZone < 0) frameZone = ProfilerZone("Frame");
+
+    double now = ProfilerNow();
+    if (!profilerActive) {
+        frameStart = -1.0;
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(recordMutex);
+    bool full = false;
+
+    // First active frame only sets the start, there's nothing to measure yet
+    if (frameStart >= 0.0) {
+        full = RecordLocked(frameZone, frameStart, now);
+
+        for (int i = 0; i < zoneCount; i++) {
+            zones[i].history[historyHead] = (float)(zones[i].frameUs / 1000.0);
+            zones[i].frameUs = 0.0;
+        }
+        historyHead = (historyHead + 1) % PROFILE_HISTORY;
+        if (historyFrames < PROFILE_HISTORY) historyFrames++;
+    } else {
+        for (int i = 0; i < zoneCount; i++) zones[i].frameUs = 0.0;
+    }
+    frameStart = now;
+
+    lock.unlock();
+    if (full) ProfilerStopCapture();
+}
+
+int ProfilerGetStats(ProfileStats* out, int maxZones) {
+    std::lock_guard<std::mutex> lock(recordMutex);
+    float sorted[PROFILE_HISTORY];
+    int n = historyFrames;
+    int count = std::min(zoneCount, maxZones);
+
+    for (int z = 0; z < count; z++) {
+        const ProfileZoneData& zone = zones[z];
+        ProfileStats& s = out[z];
+        s.name = zone.name;
+        s.minMs = s.avgMs = s.p99Ms = s.lastMs = 0.0f;
+        if (n == 0) continue;
+
+        // The ring is full or filled from slot 0, either way [0, n) is valid
+        float sum = 0.0f;
+        for (int i = 0; i < n; i++) {
+            sorted[i] = zone.history[i];
+            sum += sorted[i];
+        }
+        int p99 = std::min(n - 1, (int)(n * 0.99f));
+        std::nth_element(sorted, sorted + p99, sorted + n);
+
+        s.minMs = *std::min_element(sorted, sorted + n);
+        s.avgMs = sum / n;
+        s.p99Ms = sorted[p99];
+        s.lastMs = zone.history[(historyHead + PROFILE_HISTORY - 1) % PROFILE_HISTORY];
+    }
+    return count;
+}
+
+bool ProfilerStartCapture(const char* path) {
+    if (capturing) ProfilerStopCapture();
+
+    std::lock_guard<std::mutex> lock(recordMutex);
+    snprintf(capturePath, sizeof(capturePath), "%s", path);
+    events.clear();
+    events.reserve(PROFILE_MAX_EVENTS);
+    capturing = true;
+    UpdateActive();
+    return true;
+}
+
+void ProfilerStopCapture() {
+    std::lock_guard<std::mutex> lock(recordMutex);
+    if (!capturing) return;
+    capturing = false;
+    UpdateActive();
+
+    // On web this lands in MEMFS, pull it out from the browser console with
+    // FS.readFile('trace.json', { encoding: 'utf8' })
+    FILE* file = fopen(capturePath, "w");
+    if (file == NULL) {
+        fprintf(stderr, "profiler: could not write %s\n", capturePath);
+        return;
+    }
+
+    double origin = events.empty() ? 0.0 : events[0].start;
+    for (const TraceEvent& e : events) origin = std::min(origin, e.start);
+
+    fprintf(file, "{\"traceEvents\":[\n");
+    for (size_t i = 0; i < events.size(); i++) {
+        const TraceEvent& e = events[i];
+        fprintf(file, "{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}%s\n",
+                zones[e.zone].name, e.start - origin, e.duration, e.thread, (i + 1 < events.size()) ? "," : "");
+    }
+    fprintf(file, "]}\n");
+    fclose(file);
+
+    printf("profiler: wrote %d events to %s\n", (int)events.size(), capturePath);
+    events.clear();
+}
+
+bool ProfilerCapturing() {
+    return capturing;
+}
+
+void ProfilerSetOverlay(bool on) {
+    overlayOn = on;
+    UpdateActive();
+}
+
+bool ProfilerOverlay() {
+    return overlayOn;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+// Tiny frame profiler. Put PROFILE_SCOPE("Name") at the top of a block and
+// the time spent in it gets:
+//  - summed per frame and kept for the last PROFILE_HISTORY frames, so the
+//    F3 overlay can show min/avg/p99 per phase
+//  - written as Chrome trace events while a capture is running (open the
+//    file in chrome://tracing or ui.perfetto.dev)
+// While neither is on, a scope costs one flag check. No raylib in here, the
+// headless sim is instrumented too.
+
+#include <atomic>
+
+const int PROFILE_MAX_ZONES = 32;
+const int PROFILE_HISTORY = 240;          // frames, 4 s at 60 fps
+const int PROFILE_MAX_EVENTS = 1 << 18;   // capture stops itself when full
+
+struct ProfileStats {
+    const char* name;
+    float minMs, avgMs, p99Ms, lastMs;
+};
+
+extern std::atomic<bool> profilerActive; // overlay shown or capture running
+
+int ProfilerZone(const char* name);
+double ProfilerNow(); // microseconds
+void ProfilerRecord(int zone, double startUs, double endUs);
+
+// Closes the frame: the "Frame" zone spans from the previous call to this one
+void ProfilerEndFrame();
+
+// Rolling stats for every zone seen so far, in first-seen order
+int ProfilerGetStats(ProfileStats* out, int maxZones);
+
+bool ProfilerStartCapture(const char* path);
+void ProfilerStopCapture(); // writes the file
+bool ProfilerCapturing();
+
+void ProfilerSetOverlay(bool on);
+bool ProfilerOverlay();
+
+struct ProfileScope {
+    int zone;
+    double start;
+
+    explicit ProfileScope(int z) : zone(z), start(profilerActive ? ProfilerNow() : -1.0) {}
+    ~ProfileScope() {
+        if (start >= 0.0) ProfilerRecord(zone, start, ProfilerNow());
+    }
+};
+
+#define PROFILE_JOIN2(a, b) a##b
+#define PROFILE_JOIN(a, b) PROFILE_JOIN2(a, b)
+#define PROFILE_SCOPE(name) \
+    static const int PROFILE_JOIN(profileZone_, __LINE__) = ProfilerZone(name); \
+    ProfileScope PROFILE_JOIN(profileScope_, __LINE__)(PROFILE_JOIN(profileZone_, __LINE__))
@@ -0,0 +1,102 @@
+#include "quality.h"
+#include "particles.h"
+#include <cmath>
+
+const QualitySettings QUALITY_SETTINGS[QUALITY_TIER_COUNT] = {
+    // particles  limit          trail  bloom  bg  res
+    { 0.35f,      512,           8,     0,     1,  0.75f }, // LOW
+    { 0.6f,       2048,          14,    4,     2,  1.0f  }, // MEDIUM
+    { 1.0f,       MAX_PARTICLES, 20,    2,     2,  1.0f  }, // HIGH
+};
+
+QualityGovernor quality;
+
+// Rolling averages settle over about this long
+const float QUALITY_SMOOTHING = 0.5f;
+// Over budget by this much (a frame being missed every few) for DROP_AFTER
+// seconds goes down a tier
+const float QUALITY_DROP_RATIO = 1.2f;
+const float QUALITY_DROP_AFTER = 1.0f;
+// Work under this much of the budget for RAISE_AFTER seconds goes up one
+const float QUALITY_RAISE_RATIO = 0.5f;
+const float QUALITY_RAISE_AFTER = 5.0f;
+const float QUALITY_COOLDOWN = 3.0f;
+// A raised tier that drops again within SETTLE seconds was a failed raise:
+// the wait before the next one doubles each time (5, 10, 20, 40 s...), so a
+// tier the machine can't hold soon stops being tried. Holding a raised tier
+// that long resets it.
+const float QUALITY_SETTLE = 15.0f;
+// Loading hitches and the like say nothing about the steady state
+const float QUALITY_MAX_FRAME = 0.25f;
+
+void InitQuality(int targetFps) {
+    quality.budget = 1.0f / (float)(targetFps > 0 ? targetFps : 60);
+    quality.avgFrame = quality.avgWork = quality.budget;
+    quality.overTime = quality.underTime = 0.0f;
+    quality.cooldown = QUALITY_COOLDOWN;
+    quality.raiseAfter = QUALITY_RAISE_AFTER;
+    quality.sinceRaise = -1.0f;
+}
+
+void SetQualityTier(QualityTier tier, bool automatic) {
+    quality.tier = tier;
+    quality.automatic = automatic;
+    // New tier, new numbers: start measuring from scratch
+    quality.avgFrame = quality.avgWork = quality.budget;
+    quality.overTime = quality.underTime = 0.0f;
+    quality.cooldown = QUALITY_COOLDOWN;
+}
+
+bool UpdateQuality(float frameTime, float workTime) {
+    if (!quality.automatic) return false;
+    float dt = std::fmin(frameTime, QUALITY_MAX_FRAME);
+    workTime = std::fmin(workTime, dt);
+
+    float k = 1.0f - std::exp(-dt / QUALITY_SMOOTHING);
+    quality.avgFrame += (dt - quality.avgFrame) * k;
+    quality.avgWork += (workTime - quality.avgWork) * k;
+
+    if (quality.sinceRaise >= 0.0f) {
+        quality.sinceRaise += dt;
+        if (quality.sinceRaise >= QUALITY_SETTLE) {
+            quality.sinceRaise = -1.0f;
+            quality.raiseAfter = QUALITY_RAISE_AFTER;
+        }
+    }
+
+    if (quality.cooldown > 0.0f) {
+        quality.cooldown -= dt;
+        return false;
+    }
+
+    quality.overTime = (quality.avgFrame > quality.budget * QUALITY_DROP_RATIO) ? quality.overTime + dt : 0.0f;
+    quality.underTime = (quality.avgWork < quality.budget * QUALITY_RAISE_RATIO) ? quality.underTime + dt : 0.0f;
+
+    if (quality.overTime >= QUALITY_DROP_AFTER && quality.tier > QUALITY_LOW) {
+        if (quality.sinceRaise >= 0.0f) {
+            quality.raiseAfter *= 2.0f;
+            quality.sinceRaise = -1.0f;
+        }
+        SetQualityTier((QualityTier)(quality.tier - 1), true);
+        return true;
+    }
+    if (quality.underTime >= quality.raiseAfter && quality.tier < QUALITY_HIGH) {
+        SetQualityTier((QualityTier)(quality.tier + 1), true);
+        quality.sinceRaise = 0.0f;
+        return true;
+    }
+    return false;
+}
+
+const char* QualityTierName(QualityTier tier) {
+    switch (tier) {
+        case QUALITY_LOW: return "low";
+        case QUALITY_MEDIUM: return "medium";
+        default: return "high";
+    }
+}
+
+int QualityCount(int count) {
+    int n = (int)(count * Quality().particleScale + 0.5f);
+    return n > 0 ? n : 1;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+// Effect budgets that get scaled down when frames run long. The simulation
+// has its own fixed clock, so slow frames don't change gameplay any more,
+// but they still look bad and bursts (jump + landing particles) are exactly
+// when they happen. The governor watches rolling frame times and moves one
+// tier at a time:
+//  - down when frames run over budget (missed vsync) for a while
+//  - up only after a much longer stretch with plenty of headroom
+// and waits out a cooldown after every change, so it settles instead of
+// flipping back and forth around the limit. A raise that gets dropped again
+// soon after doubles how long the next raise has to wait, so a tier the
+// machine can't hold isn't retried every few seconds.
+enum QualityTier { QUALITY_LOW, QUALITY_MEDIUM, QUALITY_HIGH, QUALITY_TIER_COUNT };
+
+struct QualitySettings {
+    float particleScale;  // of the spawn counts in a burst
+    int particleLimit;    // live particles per pool, <= MAX_PARTICLES
+    int trailLength;      // points drawn
+    int bloomDownscale;   // 2 half res, 4 quarter, 0 no bloom
+    int backgroundLayers;
+    float renderScale;    // world resolution
+};
+
+extern const QualitySettings QUALITY_SETTINGS[QUALITY_TIER_COUNT];
+
+struct QualityGovernor {
+    QualityTier tier = QUALITY_HIGH;
+    bool automatic = true; // false when fixed with --quality
+    float budget = 1.0f / 60.0f;
+    float avgFrame = 0.0f;  // rolling frame time, vsync wait included
+    float avgWork = 0.0f;   // rolling time before the frame ends up waiting on vsync
+    float overTime = 0.0f;  // how long avgFrame has been over budget
+    float underTime = 0.0f; // how long avgWork has had headroom
+    float cooldown = 0.0f;
+    float raiseAfter = 0.0f;  // headroom needed before going up, backs off
+    float sinceRaise = -1.0f; // time on a tier we just went up to, -1 once it held
+};
+
+extern QualityGovernor quality;
+
+void InitQuality(int targetFps);
+void SetQualityTier(QualityTier tier, bool automatic);
+
+// Once a frame on the main thread with the last frame's total length and the
+// part of it spent working. Returns true if the tier changed.
+bool UpdateQuality(float frameTime, float workTime);
+
+inline const QualitySettings& Quality() { return QUALITY_SETTINGS[quality.tier]; }
+const char* QualityTierName(QualityTier tier);
+
+// Spawn count for a burst at the current tier, never less than one
+int QualityCount(int count);
@@ -0,0 +1,102 @@
+#include "replay.h"
+#include <cstdio>
+#include <cstring>
+
+const char* OutcomeName(SimOutcome outcome) {
+    switch (outcome) {
+        case SIM_DEAD: return "dead";
+        case SIM_VICTORY: return "victory";
+        default: return "running";
+    }
+}
+
+bool SaveReplay(const char* path, const Replay& replay) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        TraceLog(LOG_ERROR, "Could not write replay %s", path);
+        return false;
+    }
+
+    fprintf(file, "calculusdash-replay 1\n");
+    fprintf(file, "level %s\n", replay.levelFile.c_str());
+    for (int t : replay.jumpTicks) fprintf(file, "jump %d\n", t);
+
+    if (replay.outcome == SIM_DEAD) {
+        fprintf(file, "end dead %d %d %d\n", replay.endTick, replay.deathX, replay.deathY);
+    } else if (replay.outcome == SIM_VICTORY) {
+        fprintf(file, "end victory %d\n", replay.endTick);
+    }
+
+    fclose(file);
+    return true;
+}
+
+bool LoadReplay(const char* path, Replay& replay) {
+    replay = Replay();
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        TraceLog(LOG_ERROR, "Could not open replay %s", path);
+        return false;
+    }
+
+    char line[512];
+    int version = 0;
+    if (!fgets(line, sizeof(line), file) || sscanf(line, "calculusdash-replay %d", &version) != 1 || version != 1) {
+        TraceLog(LOG_ERROR, "%s is not a replay file", path);
+        fclose(file);
+        return false;
+    }
+
+    while (fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        int a, b, c;
+        if (strncmp(line, "level ", 6) == 0) {
+            replay.levelFile = line + 6;
+        } else if (sscanf(line, "jump %d", &a) == 1) {
+            replay.jumpTicks.push_back(a);
+        } else if (sscanf(line, "end dead %d %d %d", &a, &b, &c) == 3) {
+            replay.outcome = SIM_DEAD;
+            replay.endTick = a;
+            replay.deathX = b;
+            replay.deathY = c;
+        } else if (sscanf(line, "end victory %d", &a) == 1) {
+            replay.outcome = SIM_VICTORY;
+            replay.endTick = a;
+        }
+    }
+
+    fclose(file);
+    return true;
+}
+
+Replay RunReplay(TileGrid& grid, const Replay& replay, int maxTicks) {
+    Replay result;
+    result.levelFile = replay.levelFile;
+
+    SimState sim;
+    size_t nextJump = 0;
+
+    while (sim.outcome == SIM_RUNNING && sim.tick < maxTicks) {
+        bool jump = false;
+        while (nextJump < replay.jumpTicks.size() && replay.jumpTicks[nextJump] <= sim.tick) {
+            jump = jump || replay.jumpTicks[nextJump] == sim.tick;
+            nextJump++;
+        }
+        if (jump) result.jumpTicks.push_back(sim.tick);
+
+        grid.Scroll(sim.player.pos.x);
+        StepSimulation(sim, grid, jump);
+    }
+
+    result.outcome = sim.outcome;
+    result.endTick = sim.tick;
+    result.deathX = sim.deathX;
+    result.deathY = sim.deathY;
+    return result;
+}
+
+bool SameOutcome(const Replay& a, const Replay& b) {
+    if (a.outcome != b.outcome || a.endTick != b.endTick) return false;
+    if (a.outcome == SIM_DEAD) return a.deathX == b.deathX && a.deathY == b.deathY;
+    return true;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+// Input recordings. A replay is the level it was played on, the ticks on
+// which jump was pressed, and how the run ended. Feeding the same jumps
+// through the simulation again has to end the same way, which is what the
+// replay tool checks after a level edit.
+//
+// File format, plain text, one entry per line:
+//   calculusdash-replay 1
+//   level level.txt
+//   jump <tick>                      (one line per press, ascending)
+//   end dead <tick> <cellX> <cellY>  (spike cell that killed the player)
+//   end victory <tick>
+
+#include "sim.h"
+#include <string>
+#include <vector>
+
+struct Replay {
+    std::string levelFile = "level.txt";
+    std::vector<int> jumpTicks;
+    SimOutcome outcome = SIM_RUNNING;
+    int endTick = 0;
+    int deathX = -1, deathY = -1;
+};
+
+bool SaveReplay(const char* path, const Replay& replay);
+bool LoadReplay(const char* path, Replay& replay);
+
+// Plays the recorded jumps into a fresh simulation until it dies, wins or
+// runs for maxTicks. Returns a replay holding what actually happened.
+Replay RunReplay(TileGrid& grid, const Replay& replay, int maxTicks);
+
+bool SameOutcome(const Replay& a, const Replay& b);
+
+const char* OutcomeName(SimOutcome outcome);
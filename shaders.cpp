@@ -0,0 +1,35 @@
+#include "shaders.h"
+#include "rlgl.h"
+#include <string>
+
+#if defined(PLATFORM_WEB) || defined(__EMSCRIPTEN__)
+static const char* FS_HEADER =
+    "#version 100\n"
+    "precision mediump float;\n"
+    "#define IN varying\n"
+    "#define TEXTURE texture2D\n"
+    "#define FINAL_COLOR gl_FragColor\n";
+#else
+static const char* FS_HEADER =
+    "#version 330\n"
+    "#define IN in\n"
+    "#define TEXTURE texture\n"
+    "#define FINAL_COLOR finalColor\n"
+    "out vec4 finalColor;\n";
+#endif
+
+Shader LoadFragmentShader(const char* name, const char* body, const char* defines) {
+    std::string fs = std::string(FS_HEADER) + defines + body;
+    Shader shader = LoadShaderFromMemory(nullptr, fs.c_str());
+    // raylib hands back its default shader when compiling fails
+    if (shader.id == rlGetShaderIdDefault()) {
+        TraceLog(LOG_WARNING, "Shader %s failed to compile", name);
+        shader = { 0 };
+    }
+    return shader;
+}
+
+void UnloadFragmentShader(Shader& shader) {
+    if (shader.id != 0) UnloadShader(shader);
+    shader = { 0 };
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "raylib.h"
+
+// Fragment shaders live in the code as GLSL bodies written against a few
+// macros, so one source works on both GL versions raylib targets:
+//   IN           fragment input (in / varying)
+//   TEXTURE      texture sampling (texture / texture2D)
+//   FINAL_COLOR  the output (finalColor / gl_FragColor)
+// LoadFragmentShader puts the right header in front: GLSL 330 on desktop,
+// GLSL ES 100 on web. Vertex shader is raylib's default (fragTexCoord,
+// fragColor). `defines` goes in after the header, e.g. "#define TAPS 5\n".
+// Returns a shader with id 0 if it didn't compile.
+Shader LoadFragmentShader(const char* name, const char* body, const char* defines = "");
+void UnloadFragmentShader(Shader& shader);
@@ -0,0 +1,200 @@
+#include "sim.h"
+#include "profiler.h"
+#include <algorithm>
+
+void Player::Update(){
+    if (pos.y + height / 2 < screenHeight / 2) {
+        gravityDirection = -1;
+    } else {
+        gravityDirection = 1;
+    }
+
+    velocityY += gravity * gravityDirection;
+    if (rotating) {
+        if (fabs(rotation - targetRotation) > 0.1f) {
+        float dir = (rotation < targetRotation) ? 1 : -1;
+        rotation += dir * rotationSpeed;
+    } else {
+        rotation = targetRotation;
+        rotating = false;
+    }
+    }
+
+}
+
+bool Player::Jump() {
+    if (!isGrounded) return false;
+
+    velocityY = -jumpForce * gravityDirection;
+    targetRotation += 90.0f;
+    rotating = true;
+    isGrounded = false;
+    return true;
+}
+
+// How far along `motion` (0..1) box `a` gets before it touches `b`, or -1 if
+// it doesn't this tick. Boxes that only touch, or already overlap, don't
+// count. hitY says whether the contact is top/bottom or a side.
+static float SweptAABB(Rectangle a, Vector2 motion, Rectangle b, bool& hitY) {
+    float xEntry, xExit, yEntry, yExit;
+
+    if (motion.x > 0) {
+        xEntry = (b.x - (a.x + a.width)) / motion.x;
+        xExit = (b.x + b.width - a.x) / motion.x;
+    } else if (motion.x < 0) {
+        xEntry = (b.x + b.width - a.x) / motion.x;
+        xExit = (b.x - (a.x + a.width)) / motion.x;
+    } else {
+        if (a.x + a.width <= b.x || a.x >= b.x + b.width) return -1.0f;
+        xEntry = -INFINITY;
+        xExit = INFINITY;
+    }
+
+    if (motion.y > 0) {
+        yEntry = (b.y - (a.y + a.height)) / motion.y;
+        yExit = (b.y + b.height - a.y) / motion.y;
+    } else if (motion.y < 0) {
+        yEntry = (b.y + b.height - a.y) / motion.y;
+        yExit = (b.y - (a.y + a.height)) / motion.y;
+    } else {
+        if (a.y + a.height <= b.y || a.y >= b.y + b.height) return -1.0f;
+        yEntry = -INFINITY;
+        yExit = INFINITY;
+    }
+
+    float entry = std::max(xEntry, yEntry);
+    float exit = std::min(xExit, yExit);
+    if (entry >= exit || entry < 0.0f || entry > 1.0f) return -1.0f;
+
+    // Exact corner hits count as landing, so tile seams never snag
+    hitY = yEntry >= xEntry;
+    return entry;
+}
+
+static Rectangle SpikeRect(const TileGrid& grid, int x, int y) {
+    const float spikePadding = 8.0f;
+    Rectangle r = grid.CellRect(x, y);
+    r.x += spikePadding;
+    r.y += spikePadding;
+    r.width -= spikePadding * 2;
+    r.height -= spikePadding * 2;
+    return r;
+}
+
+void ResetSim(SimState& sim) {
+    sim = SimState();
+}
+
+SimEvents StepSimulation(SimState& sim, const TileGrid& grid, bool jump) {
+    PROFILE_SCOPE("StepSimulation");
+    SimEvents events;
+    Player& p1 = sim.player;
+
+    p1.prevPos = p1.pos;
+    p1.prevRotation = p1.rotation;
+
+    if (jump) {
+        Vector2 foot = p1.Foot();
+        if (p1.Jump()) {
+            events.jumped = true;
+            events.jumpFoot = foot;
+            events.jumpGravity = p1.gravityDirection;
+        }
+    }
+
+    if (p1.pos.x > victoryX) sim.outcome = SIM_VICTORY;
+
+    {
+        PROFILE_SCOPE("Player.Update");
+        p1.Update();
+    }
+    p1.isGrounded = false;
+
+    p1.velocityX = scrollSpeed;
+
+    // Swept collision: move along the tick's motion until the first solid
+    // tile in the way, stop on that axis, and carry on with what's left of
+    // the other one. Fast enough motion can't skip past a tile this way, and
+    // the result doesn't depend on which tile gets looked at first.
+    // Three passes covers hitting a wall and a floor in the same tick.
+    PROFILE_SCOPE("Collision");
+    Vector2 motion = { p1.velocityX, p1.velocityY };
+    for (int pass = 0; pass < 3 && (motion.x != 0 || motion.y != 0); pass++) {
+        Rectangle r = p1.GetRect();
+        Rectangle swept = { std::min(r.x, r.x + motion.x), std::min(r.y, r.y + motion.y),
+                            r.width + fabsf(motion.x), r.height + fabsf(motion.y) };
+
+        // Only the cells the swept box covers can be hit
+        int cx0, cy0, cx1, cy1;
+        grid.CellRange(swept, 0, cx0, cy0, cx1, cy1);
+
+        float toi = 1.0f;
+        bool hit = false;
+        bool hitY = false;
+        Rectangle hitRect = { 0 };
+        for (int y = cy0; y <= cy1; y++) {
+            for (int x = cx0; x <= cx1; x++) {
+                TileType t = grid.At(x, y);
+                if (t != TILE_GROUND && t != TILE_BOX) continue;
+
+                bool axisY;
+                Rectangle rect = grid.CellRect(x, y);
+                float h = SweptAABB(r, motion, rect, axisY);
+                if (h < 0.0f || h > toi || (hit && h == toi && !axisY)) continue;
+                toi = h;
+                hit = true;
+                hitY = axisY;
+                hitRect = rect;
+            }
+        }
+
+        // Spikes anywhere along the stretch actually travelled
+        if (sim.outcome != SIM_DEAD) {
+            float firstSpike = INFINITY;
+            for (int y = cy0; y <= cy1; y++) {
+                for (int x = cx0; x <= cx1; x++) {
+                    if (grid.At(x, y) != TILE_SPIKE) continue;
+
+                    Rectangle spikeRect = SpikeRect(grid, x, y);
+                    bool axisY;
+                    float h = CheckCollisionRecs(r, spikeRect) ? 0.0f : SweptAABB(r, motion, spikeRect, axisY);
+                    if (h < 0.0f || h > toi || h >= firstSpike) continue;
+                    firstSpike = h;
+                    sim.outcome = SIM_DEAD;
+                    sim.deathX = x;
+                    sim.deathY = y;
+                }
+            }
+        }
+
+        p1.pos.x += motion.x * toi;
+        p1.pos.y += motion.y * toi;
+        if (!hit) break;
+
+        // Snap flush so float error never leaves the player a hair inside
+        if (hitY) {
+            bool falling = motion.y > 0;
+            p1.pos.y = falling ? hitRect.y - p1.height : hitRect.y + hitRect.height;
+            // Landed if the floor is on the side gravity pulls towards
+            if (falling == (p1.gravityDirection == 1)) p1.isGrounded = true;
+            p1.velocityY = 0;
+            motion = { motion.x * (1.0f - toi), 0.0f };
+        } else {
+            p1.pos.x = (motion.x > 0) ? hitRect.x - p1.width : hitRect.x + hitRect.width;
+            p1.velocityX = 0;
+            motion = { 0.0f, motion.y * (1.0f - toi) };
+        }
+    }
+
+    // Check for landing (was in air, now grounded)
+    if (!sim.wasGroundedLastFrame && p1.isGrounded) {
+        events.landed = true;
+        events.landFoot = p1.Foot();
+        events.landGravity = p1.gravityDirection;
+    }
+
+    sim.wasGroundedLastFrame = p1.isGrounded;
+    sim.tick++;
+
+    return events;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+// Gameplay simulation. Nothing in here touches the window, input or drawing,
+// so it can be stepped headless (replays, level checks) as fast as the CPU
+// goes. main.cpp feeds it one jump flag per tick and turns the events it
+// reports into particles and screen shake.
+
+#include "raylib.h"
+#include "level.h"
+
+//Screen dimensions. The world is laid out in screen pixels, gravity flips
+//at the middle of the screen.
+const int screenWidth = 1280;
+const int screenHeight =720;
+
+const float gravity = 0.8f;
+const float jumpForce = 12.0f;
+const int groundY = 640;
+const int ceilingY = 80;
+const Vector2 restartPosition = { 400, groundY - 40 };
+const float scrollSpeed = 4.0f;
+const float victoryX = 12500.0f;
+
+// Fixed timestep. gravity, jumpForce, scrollSpeed and rotationSpeed are all
+// "per tick" numbers, tuned back when the game ran one tick per 60 Hz frame.
+const float SIM_DT = 1.0f / 60.0f;
+
+class Player{
+public:
+    Vector2 pos;
+
+    int gravityDirection = 1;
+
+    float width = TILE_SIZE - 10, height = TILE_SIZE - 10;
+    float velocityX = 0 , velocityY= 0;
+    float rotation = 0.0f;
+    float targetRotation = 0.0f;
+    float rotationSpeed = 6.0f;
+
+    bool rotating = false;
+    bool isGrounded = false;
+
+    // Where the last tick started, so drawing can blend between ticks
+    Vector2 prevPos;
+    float prevRotation = 0.0f;
+
+    Player(float x, float y){
+        pos = { x,y };
+        prevPos = pos;
+    }
+
+    Vector2 RenderPos(float alpha) const {
+        return { prevPos.x + (pos.x - prevPos.x) * alpha, prevPos.y + (pos.y - prevPos.y) * alpha };
+    }
+
+    // Where dust comes out: middle of whichever side is on the floor
+    Vector2 Foot() const {
+        return { pos.x + width * 0.5f, (gravityDirection == 1) ? (pos.y + height) : pos.y };
+    }
+
+    // Gravity and rotation for one tick. Moving is left to StepSimulation,
+    // which sweeps the player along its velocity against the tile grid.
+    void Update();
+
+    // Returns true if the jump happened (only possible while grounded)
+    bool Jump();
+
+    Rectangle GetRect() const {
+        return { pos.x, pos.y, width, height};
+    }
+
+};
+
+enum SimOutcome { SIM_RUNNING, SIM_DEAD, SIM_VICTORY };
+
+// Whatever the presentation side may want to react to after a tick
+struct SimEvents {
+    bool jumped = false;
+    bool landed = false;
+    Vector2 jumpFoot = { 0, 0 };
+    Vector2 landFoot = { 0, 0 };
+    int jumpGravity = 1;
+    int landGravity = 1;
+};
+
+struct SimState {
+    Player player;
+    bool wasGroundedLastFrame = true;
+    int tick = 0;
+    SimOutcome outcome = SIM_RUNNING;
+    int deathX = -1, deathY = -1; // spike cell that ended the run
+
+    SimState() : player(restartPosition.x, restartPosition.y) {}
+};
+
+void ResetSim(SimState& sim);
+
+// Advances one SIM_DT tick. `jump` is whether jump was pressed this tick.
+SimEvents StepSimulation(SimState& sim, const TileGrid& grid, bool jump);
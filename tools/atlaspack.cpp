@@ -0,0 +1,47 @@
+// Packs the sprites in assets/ into the single atlas the game draws from.
+// See atlas.h. The game packs at startup when this hasn't been run, this
+// just saves it the work (and the loose PNGs from the web bundle, if wanted).
+//
+//   atlaspack [assets dir]
+//
+// Writes <dir>/atlas.png and <dir>/atlas.txt.
+
+#include "../atlas.h"
+#include <cstdio>
+#include <string>
+
+int main(int argc, char** argv) {
+    const char* dir = (argc > 1) ? argv[1] : "assets";
+    if (argc > 2 || (argc > 1 && argv[1][0] == '-')) {
+        fprintf(stderr, "usage: %s [assets dir]\n", argv[0]);
+        return 2;
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    Image images[SPRITE_COUNT];
+    if (!LoadSpriteImages(dir, images)) {
+        fprintf(stderr, "could not load the sprites in %s\n", dir);
+        return 2;
+    }
+
+    Rectangle rects[SPRITE_COUNT];
+    Image packed = PackAtlasImage(images, rects);
+    for (Image& img : images) UnloadImage(img);
+
+    std::string png = std::string(dir) + "/atlas.png";
+    std::string table = std::string(dir) + "/atlas.txt";
+    bool ok = ExportImage(packed, png.c_str()) && SaveAtlasTable(table.c_str(), rects, packed.width, packed.height);
+    if (!ok) {
+        fprintf(stderr, "could not write %s\n", png.c_str());
+        UnloadImage(packed);
+        return 2;
+    }
+
+    printf("%s: %dx%d\n", png.c_str(), packed.width, packed.height);
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        printf("  %-9s %4d %4d %4d %4d\n", SPRITE_NAMES[i], (int)rects[i].x, (int)rects[i].y, (int)rects[i].width, (int)rects[i].height);
+    }
+    UnloadImage(packed);
+    return 0;
+}
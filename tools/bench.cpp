@@ -0,0 +1,288 @@
+// Benchmarks for the hot paths that don't need a window. Everything runs on
+// synthetic data from a fixed seed, so numbers are comparable between
+// builds and releases.
+//
+//   bench [--out results.json] [--quick] [--filter name] [--jobs N]
+//
+// Prints a table to stderr and JSON to stdout (or --out): one entry per
+// case with ns per op and ops per second, best and median of a few repeats.
+// --quick runs fewer repeats for CI smoke runs. --jobs sets how many extra
+// threads jobPool gets (default: one less than the core count).
+//
+// Cases:
+//   level_parse     index + fully decode a synthetic level.txt (1K/10K/100K columns)
+//   collision_query grid range + cell lookups around random player rects
+//   particle_update ParticlePool::Update at 400/10K/50K/100K particles
+//   sim_throughput  StepSimulation ticks per second on a synthetic level
+//   job_pool        back-to-back JobPool::Run calls of random sizes; also
+//                   checks every index ran exactly once and exits 1 if not
+
+#include "../level.h"
+#include "../sim.h"
+#include "../particles.h"
+#include "../worker.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Small LCG so the data is the same on every platform, rand() isn't
+struct Rng {
+    unsigned int state;
+    explicit Rng(unsigned int seed) : state(seed) {}
+    unsigned int Next() {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    }
+    int Range(int lo, int hi) { return lo + (int)(Next() % (unsigned int)(hi - lo + 1)); }
+    float Unit() { return (Next() & 0xFFFF) / 65535.0f; }
+};
+
+struct BenchResult {
+    std::string name;
+    std::string param; // "cols=1000" etc
+    long long opsPerRun;
+    double bestNs, medianNs; // per op
+};
+
+static std::vector<BenchResult> results;
+static int repeats = 7;
+static const char* filter = nullptr;
+static bool failed = false;
+
+static double Seconds() {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+static bool Enabled(const char* name) {
+    return filter == nullptr || strstr(name, filter) != nullptr;
+}
+
+// Runs `body` (which does `ops` operations) `repeats` times after a warmup
+template <typename F>
+static void Measure(const char* name, const std::string& param, long long ops, F body) {
+    body();
+    std::vector<double> ns;
+    for (int r = 0; r < repeats; r++) {
+        double t0 = Seconds();
+        body();
+        ns.push_back((Seconds() - t0) * 1e9 / (double)ops);
+    }
+    std::sort(ns.begin(), ns.end());
+
+    BenchResult res = { name, param, ops, ns[0], ns[ns.size() / 2] };
+    results.push_back(res);
+    fprintf(stderr, "%-16s %-14s %12.2f ns/op %14.0f ops/s\n", name, param.c_str(), res.medianNs, 1e9 / res.medianNs);
+}
+
+// Floor and ceiling like level.txt, with boxes, spikes and gaps sprinkled
+// over the middle rows
+static void WriteSyntheticLevel(const char* path, int cols, unsigned int seed) {
+    const int rows = 18;
+    std::vector<std::string> grid(rows, std::string(cols, '.'));
+    Rng rng(seed);
+
+    for (int x = 0; x < cols; x++) {
+        grid[0][x] = grid[1][x] = '#';
+        grid[rows - 2][x] = grid[rows - 1][x] = '#';
+    }
+    // Keep the first screen clear so runs get going
+    for (int x = 32; x < cols; x++) {
+        int roll = rng.Range(0, 99);
+        if (roll < 6) grid[rng.Range(2, rows - 3)][x] = 'B';
+        else if (roll < 9) grid[rows - 3][x] = '^';
+        else if (roll < 11) grid[2][x] = '^';
+    }
+
+    FILE* f = fopen(path, "w");
+    if (f == NULL) {
+        fprintf(stderr, "could not write %s\n", path);
+        exit(2);
+    }
+    for (const std::string& row : grid) fprintf(f, "%s\n", row.c_str());
+    fclose(f);
+}
+
+static void BenchLevelParse() {
+    const int sizes[3] = { 1000, 10000, 100000 };
+    for (int cols : sizes) {
+        char path[64];
+        snprintf(path, sizeof(path), "bench_level_%d.txt", cols);
+        WriteSyntheticLevel(path, cols, 1234u + cols);
+
+        Measure("level_parse", "cols=" + std::to_string(cols), cols, [&]() {
+            LoadLevelFromFile(path);
+            LoadLevel(0);
+        });
+        remove(path);
+    }
+}
+
+static void BenchCollisionQuery() {
+    const int cols = 10000;
+    const char* path = "bench_level_collision.txt";
+    WriteSyntheticLevel(path, cols, 99u);
+    LoadLevelFromFile(path);
+    LoadLevel(0);
+
+    // Player-sized rects all over the level, the same ones every run
+    const int count = 1 << 16;
+    std::vector<Rectangle> rects(count);
+    Rng rng(7u);
+    for (Rectangle& r : rects) {
+        r = { rng.Unit() * (cols - 1) * TILE_SIZE, rng.Unit() * (levelRows - 1) * TILE_SIZE, TILE_SIZE - 10, TILE_SIZE - 10 };
+    }
+
+    const int passes = 16;
+    volatile int sink = 0;
+    Measure("collision_query", "rects=65536", (long long)count * passes, [&]() {
+        int solid = 0;
+        for (int p = 0; p < passes; p++) {
+            for (const Rectangle& r : rects) {
+                int x0, y0, x1, y1;
+                tileGrid.CellRange(r, 1, x0, y0, x1, y1);
+                for (int x = x0; x <= x1; x++)
+                    for (int y = y0; y <= y1; y++)
+                        solid += tileGrid.At(x, y) != TILE_EMPTY;
+            }
+        }
+        sink = sink + solid;
+    });
+    remove(path);
+}
+
+static void BenchParticleUpdate() {
+    const int sizes[4] = { 400, 10000, 50000, 100000 };
+    for (int n : sizes) {
+        ParticlePool pool;
+        pool.Init(n);
+        Rng rng(n);
+
+        // Long lifetimes so the pool stays full and every run does the same
+        // work. The refill is timed too, it is a few % of the updates.
+        auto refill = [&]() {
+            pool.Clear();
+            for (int i = 0; i < n; i++) {
+                Vector2 pos = { rng.Unit() * 1280.0f, rng.Unit() * 720.0f };
+                Vector2 vel = { rng.Unit() * 400.0f - 200.0f, rng.Unit() * 400.0f - 200.0f };
+                pool.Spawn(pos, vel, 4.0f, 1000.0f + rng.Unit(), WHITE);
+            }
+        };
+
+        int frames = std::max(10, 4000000 / n);
+        Measure("particle_update", "n=" + std::to_string(n), (long long)n * frames, [&]() {
+            refill();
+            for (int f = 0; f < frames; f++) pool.Update(SIM_DT);
+        });
+    }
+}
+
+static void BenchSimThroughput() {
+    const int cols = 2000;
+    const char* path = "bench_level_sim.txt";
+    WriteSyntheticLevel(path, cols, 4242u);
+    LoadLevelFromFile(path);
+    LoadLevel();
+
+    // Jump on a fixed rhythm and start over whenever a run ends, the way a
+    // headless replay check would hammer StepSimulation. The level is parsed
+    // once above; a restart only resets the state, and the Scroll below then
+    // rewinds the window like the game does.
+    const long long ticks = 1000000;
+    Measure("sim_throughput", "ticks=1000000", ticks, [&]() {
+        SimState sim;
+        for (long long t = 0; t < ticks; t++) {
+            if (sim.outcome != SIM_RUNNING) sim = SimState();
+            tileGrid.Scroll(sim.player.pos.x);
+            StepSimulation(sim, tileGrid, (t % 37) == 0);
+        }
+    });
+    remove(path);
+}
+
+struct JobPoolCheck {
+    std::vector<std::atomic<int>> hits;
+    explicit JobPoolCheck(int n) : hits(n) {}
+};
+
+static void HitRange(void* ctx, int begin, int end) {
+    JobPoolCheck* check = (JobPoolCheck*)ctx;
+    for (int i = begin; i < end; i++) check->hits[i].fetch_add(1, std::memory_order_relaxed);
+}
+
+// Run() straight after Run() with a different count and chunk size each time
+// is where a thread still leaving the last one could mix up the ranges, so
+// this counts every index and fails the run on a miss or a double.
+static void BenchJobPool() {
+    const int maxCount = 20000;
+    const int runs = 20000;
+    JobPoolCheck check(maxCount);
+    Rng rng(777u);
+    Measure("job_pool", "runs=20000", runs, [&]() {
+        for (int r = 0; r < runs; r++) {
+            int count = rng.Range(1, maxCount);
+            jobPool.Run(HitRange, &check, count, rng.Range(1, 2000));
+            for (int i = 0; i < count; i++) {
+                if (check.hits[i].load(std::memory_order_relaxed) != 1 && !failed) {
+                    fprintf(stderr, "job_pool: index %d of %d ran %d times\n", i, count, check.hits[i].load());
+                    failed = true;
+                }
+                check.hits[i].store(0, std::memory_order_relaxed);
+            }
+        }
+    });
+}
+
+static void WriteJson(FILE* out) {
+    fprintf(out, "{\n  \"suite\": \"calculusdash-bench\",\n  \"version\": 1,\n  \"repeats\": %d,\n  \"results\": [\n", repeats);
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        fprintf(out, "    {\"name\": \"%s\", \"param\": \"%s\", \"ops\": %lld, \"best_ns_per_op\": %.3f, \"median_ns_per_op\": %.3f, \"ops_per_sec\": %.1f}%s\n",
+                r.name.c_str(), r.param.c_str(), r.opsPerRun, r.bestNs, r.medianNs, 1e9 / r.medianNs,
+                (i + 1 < results.size()) ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+int main(int argc, char** argv) {
+    const char* outPath = nullptr;
+    int jobs = std::max((int)std::thread::hardware_concurrency() - 1, 0);
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) outPath = argv[++i];
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) filter = argv[++i];
+        else if (strcmp(argv[i], "--quick") == 0) repeats = 2;
+        else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) jobs = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "usage: %s [--out results.json] [--quick] [--filter name] [--jobs N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+    jobPool.Start(jobs);
+
+    if (Enabled("level_parse")) BenchLevelParse();
+    if (Enabled("collision_query")) BenchCollisionQuery();
+    if (Enabled("particle_update")) BenchParticleUpdate();
+    if (Enabled("sim_throughput")) BenchSimThroughput();
+    if (Enabled("job_pool")) BenchJobPool();
+    jobPool.Stop();
+
+    FILE* out = stdout;
+    if (outPath != nullptr) {
+        out = fopen(outPath, "w");
+        if (out == NULL) {
+            fprintf(stderr, "could not write %s\n", outPath);
+            return 2;
+        }
+    }
+    WriteJson(out);
+    if (out != stdout) fclose(out);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,139 @@
+// Converts a text level into the binary level.bin the game prefers to load.
+// See level.h for the layout. Any level the game can load works as input,
+// so it also round-trips a level.bin back into a fresh one.
+//
+//   levelconv [level.txt] [level.bin]
+
+#include "../level.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+static long FileSize(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) return -1;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fclose(f);
+    return size;
+}
+
+int main(int argc, char** argv) {
+    const char* inFile = (argc > 1) ? argv[1] : "level.txt";
+    const char* outFile = (argc > 2) ? argv[2] : "level.bin";
+    if (argc > 3 || (argc > 1 && argv[1][0] == '-')) {
+        fprintf(stderr, "usage: %s [level.txt] [level.bin]\n", argv[0]);
+        return 2;
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+    auto start = std::chrono::steady_clock::now();
+    LoadLevelFromFile(inFile);
+    LoadLevel(0);
+    if (levelRows == 0) {
+        fprintf(stderr, "could not load %s\n", inFile);
+        return 2;
+    }
+    double textSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (levelRows > 0xFFFF) {
+        fprintf(stderr, "%s has too many rows (%d)\n", inFile, levelRows);
+        return 2;
+    }
+
+    // Pack every column and give each distinct one a palette slot
+    int colBytes = LevelColumnBytes(levelRows);
+    std::string packed(colBytes, '\0');
+    std::unordered_map<std::string, int> paletteIndex;
+    std::vector<std::string> palette;
+    std::vector<uint16_t> ids(levelCols);
+
+    for (int x = 0; x < levelCols; x++) {
+        memset(&packed[0], 0, colBytes);
+        for (int y = 0; y < levelRows; y++) {
+            packed[y / 4] |= (char)(tileGrid.At(x, y) << ((y % 4) * 2));
+        }
+
+        auto it = paletteIndex.find(packed);
+        int id;
+        if (it == paletteIndex.end()) {
+            id = (int)palette.size();
+            if (id > 0xFFFF) {
+                fprintf(stderr, "%s has more than 65536 distinct columns\n", inFile);
+                return 2;
+            }
+            paletteIndex.emplace(packed, id);
+            palette.push_back(packed);
+        } else {
+            id = it->second;
+        }
+
+        ids[x] = (uint16_t)id;
+    }
+
+    LevelFileHeader header;
+    memcpy(header.magic, LEVEL_FILE_MAGIC, 4);
+    header.version = LEVEL_FILE_VERSION;
+    header.rows = (uint16_t)levelRows;
+    header.cols = (uint32_t)levelCols;
+    header.paletteCount = (uint32_t)palette.size();
+    header.idBytes = (palette.size() > 256) ? 2 : 1;
+    memset(header.pad, 0, sizeof(header.pad));
+
+    std::string texts;
+    for (const LevelText& t : levelTexts) {
+        LevelTextRecord rec = { t.pos.x, t.pos.y, (uint16_t)t.fontSize, (uint16_t)t.text.size(),
+                                { t.color.r, t.color.g, t.color.b, t.color.a } };
+        unsigned char bytes[LEVEL_TEXT_RECORD_BYTES];
+        PackLevelTextRecord(rec, bytes);
+        texts.append((const char*)bytes, sizeof(bytes));
+        texts.append(t.text);
+    }
+    header.textCount = (uint32_t)levelTexts.size();
+    header.textBytes = (uint32_t)texts.size();
+
+    FILE* out = fopen(outFile, "wb");
+    if (out == NULL) {
+        fprintf(stderr, "could not write %s\n", outFile);
+        return 2;
+    }
+    unsigned char headerBytes[LEVEL_FILE_HEADER_BYTES];
+    PackLevelFileHeader(header, headerBytes);
+    fwrite(headerBytes, sizeof(headerBytes), 1, out);
+    for (uint16_t id : ids) {
+        // little-endian like the rest of the file
+        unsigned char bytes[2] = { (unsigned char)(id & 0xFF), (unsigned char)(id >> 8) };
+        fwrite(bytes, header.idBytes, 1, out);
+    }
+    for (const std::string& column : palette) fwrite(column.data(), 1, colBytes, out);
+    fwrite(texts.data(), 1, texts.size(), out);
+    fclose(out);
+
+    // Load it back the way the game will, and make sure nothing changed
+    std::vector<unsigned char> expected(tileGrid.cells);
+    std::vector<LevelText> expectedTexts(levelTexts);
+    start = std::chrono::steady_clock::now();
+    LoadLevelFromFile(outFile);
+    LoadLevel(0);
+    double binSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    bool sameTexts = levelTexts.size() == expectedTexts.size();
+    for (size_t i = 0; sameTexts && i < levelTexts.size(); i++) {
+        const LevelText& a = levelTexts[i];
+        const LevelText& b = expectedTexts[i];
+        sameTexts = a.text == b.text && a.pos.x == b.pos.x && a.pos.y == b.pos.y && a.fontSize == b.fontSize &&
+                    memcmp(&a.color, &b.color, sizeof(Color)) == 0;
+    }
+    if (tileGrid.cells != expected || !sameTexts) {
+        fprintf(stderr, "%s does not load back the same as %s\n", outFile, inFile);
+        return 1;
+    }
+
+    long inSize = FileSize(inFile);
+    long outSize = FileSize(outFile);
+    printf("%s: %d x %d, %d distinct columns, %d texts\n", inFile, levelCols, levelRows, (int)palette.size(), (int)levelTexts.size());
+    printf("%ld -> %ld bytes (%.1fx smaller), full load %.2f ms -> %.2f ms\n",
+           inSize, outSize, (double)inSize / outSize, textSeconds * 1000.0, binSeconds * 1000.0);
+    return 0;
+}
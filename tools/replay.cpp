@@ -0,0 +1,93 @@
+// Headless replay runner. Loads each replay's level, runs the recorded jumps
+// through the simulation with no window and checks the run ends exactly as
+// recorded. Exit code is non-zero if any replay diverged, so CI can run a
+// folder of recordings after every level.txt edit.
+//
+//   replay [--level file] [--max-ticks N] run1.replay run2.replay ...
+//
+// --level plays every replay against that level instead of the one stored
+// in the replay (handy for checking old recordings against an edited level).
+
+#include "../level.h"
+#include "../sim.h"
+#include "../replay.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+static void PrintOutcome(const Replay& r) {
+    if (r.outcome == SIM_DEAD) printf("dead at tick %d on spike (%d,%d)", r.endTick, r.deathX, r.deathY);
+    else printf("%s at tick %d", OutcomeName(r.outcome), r.endTick);
+}
+
+int main(int argc, char** argv) {
+    const char* levelOverride = nullptr;
+    int maxTicks = 0;
+    int firstFile = 1;
+
+    for (; firstFile < argc; firstFile++) {
+        if (strcmp(argv[firstFile], "--level") == 0 && firstFile + 1 < argc) {
+            levelOverride = argv[++firstFile];
+        } else if (strcmp(argv[firstFile], "--max-ticks") == 0 && firstFile + 1 < argc) {
+            maxTicks = atoi(argv[++firstFile]);
+        } else {
+            break;
+        }
+    }
+
+    if (firstFile >= argc) {
+        fprintf(stderr, "usage: %s [--level file] [--max-ticks N] file.replay...\n", argv[0]);
+        return 2;
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    std::string loadedLevel;
+    int failed = 0;
+    long long totalTicks = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = firstFile; i < argc; i++) {
+        Replay expected;
+        if (!LoadReplay(argv[i], expected)) {
+            failed++;
+            continue;
+        }
+
+        std::string levelFile = levelOverride ? levelOverride : expected.levelFile;
+        if (levelFile != loadedLevel) {
+            LoadLevelFromFile(levelFile.c_str());
+            LoadLevel();
+            loadedLevel = levelFile;
+        }
+        if (levelRows == 0) {
+            printf("FAIL %s: could not load level %s\n", argv[i], levelFile.c_str());
+            failed++;
+            continue;
+        }
+
+        // Enough to scroll through the whole level twice unless told otherwise
+        int limit = maxTicks > 0 ? maxTicks : (int)(2 * levelCols * TILE_SIZE / scrollSpeed) + 1;
+        Replay actual = RunReplay(tileGrid, expected, limit);
+        totalTicks += actual.endTick;
+
+        bool ok = SameOutcome(expected, actual);
+        printf("%s %s: ", ok ? "PASS" : "FAIL", argv[i]);
+        PrintOutcome(actual);
+        if (!ok) {
+            printf(", recorded ");
+            PrintOutcome(expected);
+            failed++;
+        }
+        printf("\n");
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%d/%d replays passed, %lld ticks in %.3f s", argc - firstFile - failed, argc - firstFile, totalTicks, seconds);
+    if (seconds > 0.0) printf(" (%.0fx real time)", totalTicks * SIM_DT / seconds);
+    printf("\n");
+
+    return failed == 0 ? 0 : 1;
+}
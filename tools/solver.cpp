@@ -0,0 +1,358 @@
+// Level solver / playability checker. Loads a level the same way the game
+// does and searches every jump/no-jump choice tick by tick, so nobody has to
+// play through a level.txt edit by hand to know it is still beatable.
+//
+//   solver [--threads N] [--beam N] [--max-lag TILES] [--windows N] [level.txt]
+//
+// The search is a breadth-first walk over ticks. Jumping only does anything
+// while grounded, so only grounded states branch. States that end up
+// identical (position, velocity, gravity direction, grounded) are merged,
+// keeping the one reached with the fewest jumps, so the first jump sequence
+// that wins is also the minimal one. Wide layers are expanded on several
+// threads.
+//
+// Pruning on top of the exact merge:
+//  - leaving the level vertically counts as dying, you never come back and
+//    would otherwise "win" by falling past the finish line
+//  - a player pinned against a wall falls behind the scroll; states more than
+//    --max-lag tiles behind the furthest one are dropped (default 3, 0 = off)
+//  - --beam N keeps only the N furthest states per tick (default off)
+// The last two trade exactness for speed on long levels.
+//
+// Prints whether the level can be beaten, the minimal jump sequence, and
+// the jumps with the tightest timing windows: for each jump, how many
+// consecutive ticks around it would still lead to a win.
+
+#include "../level.h"
+#include "../sim.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Layers smaller than this aren't worth waking threads for
+const int PARALLEL_MIN_STATES = 512;
+const int NO_WIN = INT_MAX / 2;
+
+// Just the part of SimState that decides what happens next. Rotation and
+// the previous-tick fields only matter for drawing.
+struct State {
+    float x, y, vy;
+    signed char gravity;
+    bool grounded;
+    unsigned char outcome;
+
+    bool operator==(const State& o) const {
+        return x == o.x && y == o.y && vy == o.vy && gravity == o.gravity && grounded == o.grounded;
+    }
+};
+
+struct StateHash {
+    size_t operator()(const State& s) const {
+        unsigned int bits[3];
+        memcpy(&bits[0], &s.x, 4);
+        memcpy(&bits[1], &s.y, 4);
+        memcpy(&bits[2], &s.vy, 4);
+        size_t h = 1469598103934665603ull;
+        for (unsigned int b : bits) h = (h ^ b) * 1099511628211ull;
+        h = (h ^ (unsigned int)(s.gravity + 1)) * 1099511628211ull;
+        return (h ^ (unsigned int)s.grounded) * 1099511628211ull;
+    }
+};
+
+struct Node {
+    State state;
+    int child[2] = { -1, -1 }; // index in the next layer: [0] no jump, [1] jump
+    int jumps = 0;             // fewest jumps taken to get here
+    int jumpsToWin = NO_WIN;
+};
+
+static State Pack(const SimState& s) {
+    const Player& p = s.player;
+    return { p.pos.x, p.pos.y, p.velocityY, (signed char)p.gravityDirection, p.isGrounded, (unsigned char)s.outcome };
+}
+
+static SimState Unpack(const State& st) {
+    SimState s;
+    s.player.pos = { st.x, st.y };
+    s.player.prevPos = s.player.pos;
+    s.player.velocityY = st.vy;
+    s.player.gravityDirection = st.gravity;
+    s.player.isGrounded = st.grounded;
+    s.wasGroundedLastFrame = st.grounded;
+    return s;
+}
+
+static bool OutsideLevel(const State& s) {
+    return s.y + TILE_SIZE < 0 || s.y > levelRows * TILE_SIZE;
+}
+
+// Stepped children of one node, before merging
+struct Expansion {
+    State next[2];
+    bool has[2];
+};
+
+static void ExpandRange(const std::vector<Node>& layer, const std::vector<int>& todo, std::vector<Expansion>& out, int begin, int end) {
+    for (int i = begin; i < end; i++) {
+        const State& st = layer[todo[i]].state;
+        Expansion& e = out[i];
+
+        for (int c = 0; c < 2; c++) {
+            e.has[c] = (c == 0) || st.grounded;
+            if (!e.has[c]) continue;
+
+            SimState s = Unpack(st);
+            StepSimulation(s, tileGrid, c == 1);
+            e.next[c] = Pack(s);
+            if (OutsideLevel(e.next[c])) e.next[c].outcome = SIM_DEAD;
+        }
+    }
+}
+
+static void Expand(const std::vector<Node>& layer, const std::vector<int>& todo, std::vector<Expansion>& out, int threads) {
+    int n = (int)todo.size();
+    out.resize(n);
+
+    if (threads <= 1 || n < PARALLEL_MIN_STATES) {
+        ExpandRange(layer, todo, out, 0, n);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    int per = (n + threads - 1) / threads;
+    for (int t = 0; t < threads; t++) {
+        int begin = t * per;
+        int end = std::min(n, begin + per);
+        if (begin >= end) break;
+        workers.emplace_back(ExpandRange, std::cref(layer), std::cref(todo), std::ref(out), begin, end);
+    }
+    for (auto& w : workers) w.join();
+}
+
+int main(int argc, char** argv) {
+    const char* levelFile = "level.txt";
+    int threads = (int)std::thread::hardware_concurrency();
+    int beam = 0;
+    float maxLagTiles = 3.0f;
+    int windowsShown = 5;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--beam") == 0 && i + 1 < argc) beam = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--max-lag") == 0 && i + 1 < argc) maxLagTiles = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--windows") == 0 && i + 1 < argc) windowsShown = atoi(argv[++i]);
+        else if (argv[i][0] == '-') {
+            fprintf(stderr, "usage: %s [--threads N] [--beam N] [--max-lag TILES] [--windows N] [level.txt]\n", argv[0]);
+            return 2;
+        }
+        else levelFile = argv[i];
+    }
+    if (threads < 1) threads = 1;
+
+    SetTraceLogLevel(LOG_WARNING);
+    // States are spread over many columns at once, so no streaming here
+    LoadLevelFromFile(levelFile);
+    LoadLevel(0);
+    if (levelRows == 0) {
+        fprintf(stderr, "could not load %s\n", levelFile);
+        return 2;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    int maxTicks = (int)(2 * levelCols * TILE_SIZE / scrollSpeed) + 1;
+
+    // layers[t] = distinct states after t ticks
+    std::vector<std::vector<Node>> layers(1);
+    Node root;
+    root.state = Pack(SimState());
+    layers[0].push_back(root);
+
+    std::vector<int> todo;
+    std::vector<Expansion> expansions;
+    std::unordered_map<State, int, StateHash> seen;
+    long long statesVisited = 1;
+    long long statesPruned = 0;
+    float furthestX = restartPosition.x;
+    int furthestTick = 0;
+
+    for (int t = 0; t < maxTicks; t++) {
+        // Finished states are leaves, only running ones get expanded
+        todo.clear();
+        for (int i = 0; i < (int)layers[t].size(); i++) {
+            if (layers[t][i].state.outcome == SIM_RUNNING) todo.push_back(i);
+        }
+        if (todo.empty()) break;
+
+        Expand(layers[t], todo, expansions, threads);
+
+        std::vector<Node> next;
+        seen.clear();
+        for (int r = 0; r < (int)todo.size(); r++) {
+            Node& parent = layers[t][todo[r]];
+            for (int c = 0; c < 2; c++) {
+                if (!expansions[r].has[c]) continue;
+                const State& s = expansions[r].next[c];
+                if (s.outcome == SIM_DEAD) continue;
+
+                int jumps = parent.jumps + c;
+                auto it = seen.find(s);
+                if (it == seen.end()) {
+                    seen.emplace(s, (int)next.size());
+                    parent.child[c] = (int)next.size();
+                    Node n;
+                    n.state = s;
+                    n.jumps = jumps;
+                    next.push_back(n);
+                } else {
+                    parent.child[c] = it->second;
+                    Node& existing = next[it->second];
+                    if (jumps < existing.jumps) existing.jumps = jumps;
+                }
+            }
+        }
+
+        // Drop states that fell too far behind, then apply the beam. Links
+        // into dropped states are cleared so the backward pass ignores them.
+        float frontX = -1e30f;
+        for (const Node& n : next) frontX = std::max(frontX, n.state.x);
+
+        std::vector<int> order;
+        for (int i = 0; i < (int)next.size(); i++) {
+            if (maxLagTiles <= 0.0f || next[i].state.x >= frontX - maxLagTiles * TILE_SIZE) order.push_back(i);
+        }
+        if (beam > 0 && (int)order.size() > beam) {
+            std::sort(order.begin(), order.end(), [&](int a, int b) {
+                if (next[a].state.x != next[b].state.x) return next[a].state.x > next[b].state.x;
+                return next[a].jumps < next[b].jumps;
+            });
+            order.resize(beam);
+        }
+        if (order.size() < next.size()) {
+            std::vector<int> remap(next.size(), -1);
+            std::vector<Node> kept;
+            kept.reserve(order.size());
+            for (int i : order) {
+                remap[i] = (int)kept.size();
+                kept.push_back(next[i]);
+            }
+            for (int r : todo) {
+                for (int c = 0; c < 2; c++) {
+                    int& ch = layers[t][r].child[c];
+                    if (ch >= 0) ch = remap[ch];
+                }
+            }
+            statesPruned += (long long)(next.size() - kept.size());
+            next.swap(kept);
+        }
+
+        statesVisited += (long long)next.size();
+        if (frontX > furthestX) {
+            furthestX = frontX;
+            furthestTick = t + 1;
+        }
+
+        layers.push_back(std::move(next));
+    }
+
+    // Backward pass: fewest further jumps needed to win from every node
+    for (int t = (int)layers.size() - 1; t >= 0; t--) {
+        for (Node& n : layers[t]) {
+            if (n.state.outcome == SIM_VICTORY) {
+                n.jumpsToWin = 0;
+                continue;
+            }
+            int best = NO_WIN;
+            for (int c = 0; c < 2; c++) {
+                if (n.child[c] < 0) continue;
+                best = std::min(best, layers[t + 1][n.child[c]].jumpsToWin + c);
+            }
+            n.jumpsToWin = best;
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const Node& first = layers[0][0];
+
+    printf("level: %s (%d x %d)\n", levelFile, levelCols, levelRows);
+    printf("searched %lld states (%lld pruned) over %d ticks in %.3f s on %d thread(s)\n",
+           statesVisited, statesPruned, (int)layers.size() - 1, seconds, threads);
+
+    if (first.jumpsToWin >= NO_WIN) {
+        printf("UNSOLVABLE: furthest reach x=%.0f (column %d) at tick %d\n",
+               furthestX, (int)(furthestX / TILE_SIZE), furthestTick);
+        return 1;
+    }
+
+    // Walk the cheapest route and remember the node taken on every tick
+    std::vector<int> pathIndex;
+    std::vector<int> jumpTicks;
+    int idx = 0;
+    for (int t = 0; ; t++) {
+        pathIndex.push_back(idx);
+        const Node& n = layers[t][idx];
+        if (n.state.outcome == SIM_VICTORY) break;
+
+        int take = 0;
+        for (int c = 0; c < 2; c++) {
+            if (n.child[c] >= 0 && layers[t + 1][n.child[c]].jumpsToWin + c == n.jumpsToWin) {
+                take = c;
+                break;
+            }
+        }
+        if (take == 1) jumpTicks.push_back(t);
+        idx = n.child[take];
+    }
+
+    int winTick = (int)pathIndex.size() - 1;
+    printf("SOLVABLE: %d jump(s), victory at tick %d (%.2f s)\n", first.jumpsToWin, winTick, winTick * SIM_DT);
+    printf("jump ticks:");
+    for (int t : jumpTicks) printf(" %d", t);
+    printf("\n");
+
+    // Timing window of a jump: how far it can slide earlier along the chosen
+    // route, or later along the no-jump continuation, and still win
+    struct Window { int tick, early, late; };
+    std::vector<Window> windows;
+    for (int j = 0; j < (int)jumpTicks.size(); j++) {
+        int t = jumpTicks[j];
+        int prevJump = (j > 0) ? jumpTicks[j - 1] : -1;
+        Window w = { t, 0, 0 };
+
+        for (int e = t - 1; e > prevJump; e--) {
+            const Node& n = layers[e][pathIndex[e]];
+            if (n.child[1] < 0 || layers[e + 1][n.child[1]].jumpsToWin >= NO_WIN) break;
+            w.early++;
+        }
+
+        int cur = layers[t][pathIndex[t]].child[0];
+        for (int l = t + 1; l + 1 < (int)layers.size() && cur >= 0; l++) {
+            const Node& n = layers[l][cur];
+            if (n.child[1] < 0 || layers[l + 1][n.child[1]].jumpsToWin >= NO_WIN) break;
+            w.late++;
+            cur = n.child[0];
+        }
+
+        windows.push_back(w);
+    }
+
+    std::sort(windows.begin(), windows.end(), [](const Window& a, const Window& b) {
+        return (a.early + a.late) < (b.early + b.late);
+    });
+
+    printf("tightest timing windows:\n");
+    for (int i = 0; i < (int)windows.size() && i < windowsShown; i++) {
+        const Window& w = windows[i];
+        float x = layers[w.tick][pathIndex[w.tick]].state.x;
+        int ticks = w.early + w.late + 1;
+        printf("  tick %5d  column %4d  window %2d tick(s) (%3.0f ms)  [-%d, +%d]\n",
+               w.tick, (int)(x / TILE_SIZE), ticks, ticks * SIM_DT * 1000.0f, w.early, w.late);
+    }
+
+    return 0;
+}
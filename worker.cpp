@@ -0,0 +1,124 @@
+#include "worker.h"
+#include <algorithm>
+
+void FrameWorker::Start(void (*fn)()) {
+    job = fn;
+    quit = false;
+    busy = false;
+    thread = std::thread([this]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            cv.wait(lock, [this]() { return busy || quit; });
+            if (quit) return;
+
+            lock.unlock();
+            job();
+            lock.lock();
+
+            busy = false;
+            cv.notify_all();
+        }
+    });
+}
+
+void FrameWorker::Stop() {
+    if (!Running()) return;
+    Wait();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    cv.notify_all();
+    thread.join();
+}
+
+void FrameWorker::Kick() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        busy = true;
+    }
+    cv.notify_all();
+}
+
+void FrameWorker::Wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [this]() { return !busy; });
+}
+
+JobPool jobPool;
+
+void JobPool::Start(int threadCount) {
+    Stop();
+    quit = false;
+    for (int i = 0; i < threadCount; i++) {
+        threads.emplace_back([this]() {
+            unsigned seen = 0;
+            std::unique_lock<std::mutex> lock(mutex);
+            for (;;) {
+                wake.wait(lock, [&]() { return quit || generation != seen; });
+                if (quit) return;
+                seen = generation;
+                active++;
+
+                lock.unlock();
+                RunChunks();
+                lock.lock();
+
+                // Run() waits for active to drop to 0 before it touches the
+                // job fields again, so a thread that woke late and is still
+                // in here never sees them change under it
+                if (--active == 0 && pending == 0) done.notify_all();
+            }
+        });
+    }
+}
+
+void JobPool::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    wake.notify_all();
+    for (std::thread& t : threads) t.join();
+    threads.clear();
+}
+
+void JobPool::RunChunks() {
+    for (;;) {
+        int begin = next.fetch_add(1) * chunk;
+        if (begin >= count) return;
+        fn(ctx, begin, std::min(begin + chunk, count));
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--pending == 0 && active == 0) done.notify_all();
+    }
+}
+
+void JobPool::Run(RangeFn rangeFn, void* rangeCtx, int itemCount, int minPerJob) {
+    int jobs = std::min(Threads() + 1, itemCount / std::max(minPerJob, 1));
+    if (jobs < 2) {
+        if (itemCount > 0) rangeFn(rangeCtx, 0, itemCount);
+        return;
+    }
+
+    {
+        // A thread woken for the last Run() can get the lock after it
+        // returned and still be heading into RunChunks(). Let it find
+        // nothing left and leave before changing what it reads.
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this]() { return active == 0; });
+        fn = rangeFn;
+        ctx = rangeCtx;
+        count = itemCount;
+        chunk = (itemCount + jobs - 1) / jobs;
+        next = 0;
+        pending = jobs;
+        generation++;
+    }
+    wake.notify_all();
+
+    RunChunks();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this]() { return pending == 0 && active == 0; });
+}
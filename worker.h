@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// One background thread that runs the same job each time it gets kicked.
+// Kick() and Wait() are the only places it synchronises, once a frame each:
+// between the two, whatever the job touches belongs to the worker, the rest
+// of the time it belongs to the caller. Nothing in between takes a lock.
+struct FrameWorker {
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable cv;
+    void (*job)() = nullptr;
+    bool busy = false;
+    bool quit = false;
+
+    void Start(void (*fn)());
+    void Stop();
+    bool Running() const { return thread.joinable(); }
+
+    void Kick(); // worker has to be idle, call Wait() first
+    void Wait(); // returns once the last kicked job is done
+};
+
+// A few threads for splitting one big loop into ranges. Run() hands out
+// chunks of at least minPerJob items, the calling thread does its share too,
+// and it returns once every range is done. With no threads started (web, or
+// a single core) it just calls fn on the whole range. One caller at a time.
+struct JobPool {
+    typedef void (*RangeFn)(void* ctx, int begin, int end);
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake, done;
+    RangeFn fn = nullptr;
+    void* ctx = nullptr;
+    int count = 0, chunk = 0;
+    std::atomic<int> next{0};
+    int pending = 0;         // chunks not finished yet
+    int active = 0;          // threads still inside the current Run()
+    unsigned generation = 0; // bumped by every Run()
+    bool quit = false;
+
+    void Start(int threadCount);
+    void Stop();
+    int Threads() const { return (int)threads.size(); }
+
+    void Run(RangeFn fn, void* ctx, int count, int minPerJob);
+    void RunChunks();
+};
+
+// Shared by everything that wants to go wide (particles for now). Started by
+// the game on desktop, left empty on web.
+extern JobPool jobPool;